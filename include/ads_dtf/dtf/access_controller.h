@@ -7,63 +7,153 @@
 
 #include "ads_dtf/utils/enum_cast.h"
 #include "ads_dtf/dtf/access_mode.h"
+#include "ads_dtf/dtf/data_slot.h"
 #include "ads_dtf/dtf/data_type.h"
 #include "ads_dtf/dtf/life_span.h"
 #include "ads_dtf/dtf/user.h"
+#include <algorithm>
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
 
 namespace ads_dtf {
 
+// Access modes as a dense user by (data slot, span) matrix of 2-bit entries.
+// Rows are UserSlot indices and columns DataSlot indices, so a check is a
+// shift and a mask. The matrix is kept in this form while it is being built.
 struct AccessController {
-    bool Register(UserId user, DataType data, LifeSpan span, AccessMode mode) {
-        auto dataKey = LifeDataType(data, span);
-        auto& accessorInfo = accessors_[user];
-        auto result = accessorInfo.find(dataKey);
-        if (result != accessorInfo.end()) {
+    bool Register(UserId user, SlotIndex row, DataType dtype, LifeSpan span, SlotIndex slot, AccessMode mode) {
+        if (row == INVALID_SLOT || slot == INVALID_SLOT) {
             return false;
         }
-        accessorInfo[dataKey] = mode;
+
+        auto& matrix = matrices_[enum_id_cast(span)];
+        matrix.Reserve(row + 1, slot + 1);
+        if (matrix.Get(row, slot) != AccessMode::None) {
+            return false;
+        }
+        matrix.Set(row, slot, mode);
+        rows_[user] = row;
+
+        auto& columns = columns_[enum_id_cast(span)];
+        if (slot >= columns.size()) {
+            columns.resize(slot + 1, nullptr);
+        }
+        columns[slot] = dtype;
         return true;
     }
 
-    AccessMode GetAccessMode(UserId user, DataType data, LifeSpan span) const {
-        auto accessor = accessors_.find(user);
-        if (accessor == accessors_.end()) {
-            return AccessMode::None;
+    DataType TypeOf(LifeSpan span, SlotIndex slot) const {
+        auto& columns = columns_[enum_id_cast(span)];
+        return slot < columns.size() ? columns[slot] : nullptr;
+    }
+
+    void Seal() {
+        for (auto& matrix : matrices_) {
+            matrix.Shrink();
         }
-        auto dataAccessIter = accessor->second.find(LifeDataType(data, span));
-        if (dataAccessIter == accessor->second.end()) {
+        for (auto& columns : columns_) {
+            columns.shrink_to_fit();
+        }
+    }
+
+    // how many users registered each mode on one data column
+    struct ColumnUsage {
+        std::size_t creators{0};
+        std::size_t writers{0};
+        std::size_t readers{0};
+    };
+
+    ColumnUsage GetColumnUsage(LifeSpan span, SlotIndex slot) const {
+        ColumnUsage usage;
+        auto& matrix = matrices_[enum_id_cast(span)];
+        for (SlotIndex row = 0; row < matrix.Rows(); row++) {
+            switch (matrix.Get(row, slot)) {
+            case AccessMode::Create: usage.creators++; break;
+            case AccessMode::Write: usage.writers++; break;
+            case AccessMode::Read: usage.readers++; break;
+            default: break;
+            }
+        }
+        return usage;
+    }
+
+    AccessMode GetAccessModeAt(SlotIndex row, LifeSpan span, SlotIndex slot) const {
+        return matrices_[enum_id_cast(span)].Get(row, slot);
+    }
+
+    AccessMode GetAccessMode(UserId user, LifeSpan span, SlotIndex slot) const {
+        auto row = rows_.find(user);
+        if (row == rows_.end()) {
             return AccessMode::None;
         }
-        return dataAccessIter->second;
+        return GetAccessModeAt(row->second, span, slot);
     }
 
 private:
-    struct LifeDataType {
-        LifeDataType(DataType dtype, LifeSpan span) 
-        : dtype_(dtype), span_(span) {}
+    struct Matrix {
+        using Word = std::uint64_t;
+        static constexpr std::size_t MODES_PER_WORD = 32;
 
-        bool operator==(const LifeDataType& other) const {
-            return dtype_ == other.dtype_ && span_ == other.span_;
+        // grows the row stride geometrically, existing entries are copied over
+        void Reserve(std::size_t rows, std::size_t columns) {
+            std::size_t stride = stride_;
+            while (stride * MODES_PER_WORD < columns) {
+                stride = std::max<std::size_t>(1, stride * 2);
+            }
+            if (stride != stride_) {
+                std::vector<Word> words(rows_ * stride, 0);
+                for (std::size_t row = 0; row < rows_; row++) {
+                    std::copy(words_.begin() + row * stride_, words_.begin() + (row + 1) * stride_, words.begin() + row * stride);
+                }
+                words_ = std::move(words);
+                stride_ = stride;
+            }
+            if (rows > rows_) {
+                rows_ = rows;
+                words_.resize(rows_ * stride_, 0);
+            }
         }
 
-        std::size_t Hash() const {
-            return std::hash<DataType>()(dtype_) ^ std::hash<int>()(enum_id_cast(span_));
+        std::size_t Rows() const {
+            return rows_;
+        }
+
+        void Shrink() {
+            words_.shrink_to_fit();
         }
-    private:
-        DataType dtype_;
-        LifeSpan span_;
-    };
 
-    struct LifeDataTypeHash {
-        std::size_t operator()(const LifeDataType& key) const {
-            return key.Hash();
+        // an all zero word reads as AccessMode::None
+        AccessMode Get(std::size_t row, std::size_t column) const {
+            if (row >= rows_ || column >= stride_ * MODES_PER_WORD) {
+                return AccessMode::None;
+            }
+            auto bits = (words_[row * stride_ + column / MODES_PER_WORD] >> Shift(column)) & 3;
+            return static_cast<AccessMode>((bits + 3) & 3);
         }
+
+        void Set(std::size_t row, std::size_t column, AccessMode mode) {
+            auto& word = words_[row * stride_ + column / MODES_PER_WORD];
+            auto bits = Word((static_cast<unsigned>(mode) + 1) & 3);
+            word = (word & ~(Word(3) << Shift(column))) | (bits << Shift(column));
+        }
+
+    private:
+        static std::size_t Shift(std::size_t column) {
+            return (column % MODES_PER_WORD) * 2;
+        }
+
+    private:
+        std::vector<Word> words_;
+        std::size_t rows_{0};
+        std::size_t stride_{0};
     };
 
 private:
-    using DataAccessMap = std::unordered_map<LifeDataType, AccessMode, LifeDataTypeHash>;
-    std::unordered_map<UserId, DataAccessMap> accessors_;
+    Matrix matrices_[enum_id_cast(LifeSpan::Max)];
+    std::vector<DataType> columns_[enum_id_cast(LifeSpan::Max)];
+    // only consulted by the type erased lookup, typed checks use UserSlot
+    std::unordered_map<UserId, SlotIndex> rows_;
 };
 
 }
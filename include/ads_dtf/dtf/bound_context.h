@@ -0,0 +1,61 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef BOUND_CONTEXT_H
+#define BOUND_CONTEXT_H
+
+#include "ads_dtf/dtf/data_manager.h"
+#include <tuple>
+
+namespace ads_dtf {
+
+// The data a processor touches, resolved once after the manager is sealed
+// into a block of object pointers. Fetch then reads the cell directly and
+// returns the same const or non-const OptionalPtr as DataContext::Fetch.
+//
+// BoundContext<Planner, RoadMap, Trajectory> bound(manager);
+// bound.Fetch<Trajectory>()->Plan(*bound.Fetch<RoadMap>());
+//
+// C++ can not enumerate the Permission specializations of a USER, so the
+// data types are listed explicitly.
+template<typename USER, typename... DTYPEs>
+struct BoundContext {
+    explicit BoundContext(DataManager& manager)
+    : manager_(manager), bindings_(manager.BindData<USER, DTYPEs, SpanOf<DTYPEs>()>()...) {
+    }
+
+    template<typename DTYPE>
+    auto Fetch() {
+        static_assert((... || std::is_same<DTYPE, DTYPEs>::value), "Data is not bound to the context");
+        constexpr LifeSpan span = SpanOf<DTYPE>();
+
+        auto dataPtr = manager_.FetchBound<USER, DTYPE, span>(std::get<DataManager::BoundData<DTYPE, span>>(bindings_));
+        if constexpr (Permission<USER, DTYPE, span>::mode == AccessMode::Read) {
+            return OptionalPtr<const DTYPE, SyncMode::None>(dataPtr);
+        } else {
+            return OptionalPtr<DTYPE, SyncMode::None>(dataPtr);
+        }
+    }
+
+    // false when binding any of the data failed, e.g. the manager was not sealed
+    bool IsBound() const {
+        return std::apply([](const auto&... bound) { return (... && (bound.object != nullptr)); }, bindings_);
+    }
+
+private:
+    template<typename DTYPE>
+    static constexpr LifeSpan SpanOf() {
+        constexpr LifeSpan span = PermissionQuery<USER, DTYPE, LifeSpan::Max>::span;
+        static_assert(span != LifeSpan::Max, "Invalid access to data of lifespan!");
+        return span;
+    }
+
+private:
+    DataManager& manager_;
+    std::tuple<DataManager::BoundData<DTYPEs, SpanOf<DTYPEs>()>...> bindings_;
+};
+
+}
+
+#endif
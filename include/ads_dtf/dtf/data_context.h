@@ -6,6 +6,7 @@
 #define DATA_CONTEXT_H
 
 #include "ads_dtf/dtf/data_manager.h"
+#include <tuple>
 
 namespace ads_dtf {
 
@@ -19,10 +20,43 @@ struct DataContext {
         return manager_.Fetch<USER, DTYPE, PermissionQuery<USER, DTYPE, SPAN>::span>();
     }
 
+    template<typename DTYPE, LifeSpan SPAN = LifeSpan::Max, typename USER>
+    auto Fetch(const USER* user, InstanceIndex instance) {
+        static_assert(PermissionQuery<USER, DTYPE, SPAN>::span != LifeSpan::Max, "Invalid access to data of lifespan!");
+        return manager_.Fetch<USER, DTYPE, PermissionQuery<USER, DTYPE, SPAN>::span>(instance.value);
+    }
+
+    // Fetches several data types in one call, for structured bindings:
+    // auto [a, b, c] = context.FetchAll<A, B, C>(this);
+    // A convenience only, each type is checked and looked up as by Fetch.
+    template<typename... DTYPEs, typename USER>
+    auto FetchAll(const USER* user) {
+        static_assert(sizeof...(DTYPEs) > 0, "Invalid FetchAll");
+        return std::make_tuple(Fetch<DTYPEs>(user)...);
+    }
+
+    template<typename DTYPE, LifeSpan SPAN = LifeSpan::Max, typename USER>
+    auto History(const USER*) const {
+        static_assert(PermissionQuery<USER, DTYPE, SPAN>::span != LifeSpan::Max, "Invalid access to data of lifespan!");
+        return manager_.History<USER, DTYPE, PermissionQuery<USER, DTYPE, SPAN>::span>();
+    }
+
+    template<typename DTYPE, LifeSpan SPAN = LifeSpan::Max, typename USER>
+    auto History(const USER*, InstanceIndex instance) const {
+        static_assert(PermissionQuery<USER, DTYPE, SPAN>::span != LifeSpan::Max, "Invalid access to data of lifespan!");
+        return manager_.History<USER, DTYPE, PermissionQuery<USER, DTYPE, SPAN>::span>(instance.value);
+    }
+
     template<typename DTYPE, LifeSpan SPAN = LifeSpan::Max, typename USER, typename... ARGs>
     auto Create(const USER*, ARGs&&... args) {
         static_assert(PermissionQuery<USER, DTYPE, SPAN>::span != LifeSpan::Max, "Invalid access to data of lifespan!");
-        return manager_.Create<USER, DTYPE, PermissionQuery<USER, DTYPE, SPAN>::span>(std::forward<ARGs>(args)...);
+        return manager_.Create<USER, DTYPE, PermissionQuery<USER, DTYPE, SPAN>::span>(0, std::forward<ARGs>(args)...);
+    }
+
+    template<typename DTYPE, LifeSpan SPAN = LifeSpan::Max, typename USER, typename... ARGs>
+    auto Create(const USER*, InstanceIndex instance, ARGs&&... args) {
+        static_assert(PermissionQuery<USER, DTYPE, SPAN>::span != LifeSpan::Max, "Invalid access to data of lifespan!");
+        return manager_.Create<USER, DTYPE, PermissionQuery<USER, DTYPE, SPAN>::span>(instance.value, std::forward<ARGs>(args)...);
     }
 
     template<typename DTYPE, LifeSpan SPAN = LifeSpan::Max, typename USER>
@@ -31,10 +65,22 @@ struct DataContext {
         manager_.Destroy<USER, DTYPE, PermissionQuery<USER, DTYPE, SPAN>::span>();
     }
 
+    template<typename DTYPE, LifeSpan SPAN = LifeSpan::Max, typename USER>
+    void Destroy(const USER*, InstanceIndex instance) {
+        static_assert(PermissionQuery<USER, DTYPE, SPAN>::span != LifeSpan::Max, "Invalid access to data of lifespan!");
+        manager_.Destroy<USER, DTYPE, PermissionQuery<USER, DTYPE, SPAN>::span>(instance.value);
+    }
+
 private:
     DataManager& manager_;
 };
 
+// true when every pointer returned by FetchAll holds data
+template<typename... PTRs>
+bool all_present(const std::tuple<PTRs...>& ptrs) {
+    return std::apply([](const PTRs&... ptr) { return (ptr.HasValue() && ...); }, ptrs);
+}
+
 }
 
 #endif
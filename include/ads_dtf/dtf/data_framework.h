@@ -17,7 +17,17 @@ struct DataFramework {
 
     template<typename USER, typename DTYPE, LifeSpan SPAN, AccessMode MODE>
     void Register() {
-        manager_.Apply<USER, DTYPE>(SPAN, MODE);
+        manager_.Apply<USER, DTYPE, SPAN>(MODE);
+    }
+
+    // Finishes registration, optionally placing data on the NUMA nodes of its
+    // processors first and sharing bytes between Frame data given the order
+    // the processors run in. Registrations after this are rejected.
+    void Seal(const NumaNodeMap& nodeMap = NumaNodeMap(), const ProcessorOrder& order = ProcessorOrder()) {
+        if (!nodeMap.Entries().empty()) {
+            manager_.PlaceOnNodes(nodeMap);
+        }
+        manager_.Seal(order);
     }
 
     DataManager& GetManager() {
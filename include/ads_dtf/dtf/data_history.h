@@ -0,0 +1,60 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef DATA_HISTORY_H
+#define DATA_HISTORY_H
+
+#include "ads_dtf/utils/optional_ptr.h"
+#include <cstddef>
+
+namespace ads_dtf {
+
+// Zero-copy view of the last DEPTH frames of a data type, age 0 is the
+// current frame. Only valid until the next reset of the data's lifespan.
+template<typename T, std::size_t DEPTH>
+struct DataHistory {
+    template<typename AT>
+    explicit DataHistory(AT at) {
+        for (std::size_t age = 0; age < DEPTH; age++) {
+            frames_[age] = at(age);
+        }
+    }
+
+    constexpr std::size_t Size() const {
+        return DEPTH;
+    }
+
+    OptionalPtr<const T> operator[](std::size_t age) const {
+        return OptionalPtr<const T>(age < DEPTH ? frames_[age] : nullptr);
+    }
+
+    template<typename TS, typename GETTER>
+    OptionalPtr<const T> Nearest(TS timestamp, GETTER getTimestamp) const {
+        const T* nearest = nullptr;
+        TS minDistance{};
+        for (auto frame : frames_) {
+            if (!frame) continue;
+
+            TS ts = getTimestamp(*frame);
+            TS distance = (ts > timestamp) ? (ts - timestamp) : (timestamp - ts);
+            if (!nearest || distance < minDistance) {
+                nearest = frame;
+                minDistance = distance;
+            }
+        }
+        return OptionalPtr<const T>(nearest);
+    }
+
+    template<typename TS>
+    OptionalPtr<const T> Nearest(TS timestamp) const {
+        return Nearest(timestamp, [](const T& data) { return static_cast<TS>(data.timestamp); });
+    }
+
+private:
+    const T* frames_[DEPTH];
+};
+
+}
+
+#endif
@@ -6,199 +6,1113 @@
 #define DATA_MANAGER_H
 
 #include "ads_dtf/dtf/access_controller.h"
+#include "ads_dtf/dtf/data_slot.h"
+#include "ads_dtf/dtf/data_history.h"
+#include "ads_dtf/dtf/data_type.h"
+#include "ads_dtf/dtf/memory_plan.h"
+#include "ads_dtf/dtf/numa_node_map.h"
 #include "ads_dtf/dtf/permission.h"
+#include "ads_dtf/dtf/processor_order.h"
 #include "ads_dtf/utils/placement.h"
+#include "ads_dtf/utils/arena.h"
+#include "ads_dtf/utils/mapped_region.h"
+#include "ads_dtf/utils/dynamic_bitset.h"
+#include "ads_dtf/utils/atomic_bitset.h"
 #include "ads_dtf/utils/enum_cast.h"
 #include "ads_dtf/utils/auto_construct.h"
 #include "ads_dtf/utils/auto_clear.h"
+#include "ads_dtf/utils/auto_reset.h"
+#include "ads_dtf/utils/mailbox.h"
 #include "ads_dtf/utils/optional_ptr.h"
-#include <unordered_map>
-#include <memory>
+#include "ads_dtf/utils/seq_lock.h"
+#include "ads_dtf/utils/retire_list.h"
+#include "ads_dtf/utils/type_name.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
 
 namespace ads_dtf
 {
 
 struct DataContext;
 struct DataFramework;
+template<typename USER, typename... DTYPEs>
+struct BoundContext;
 
 struct DataManager {
-    template<typename USER, typename DTYPE>
-    bool Apply(LifeSpan span, AccessMode mode) {
+    template<typename USER, typename DTYPE, LifeSpan SPAN>
+    bool Apply(AccessMode mode) {
+        static_assert(SPAN < LifeSpan::Max, "Invalid LifeSpan");
+
+        if (sealed_) {
+            std::cout << "Registration is sealed, rejected dtype: " << TypeIdOf<DTYPE>() << std::endl;
+            return false;
+        }
+
         UserId user = TypeIdOf<USER>();
-        DataType dtype = TypeIdOf<DTYPE>();
+        SlotIndex row = UserSlot<USER>::Assign();
+        SlotIndex slot = DataSlot<DTYPE, SPAN>::Assign();
 
-        if (!acl_.Register(user, dtype, span, mode)) {
+        if (!acl_.Register(user, row, TypeIdOf<DTYPE>(), SPAN, slot, mode)) {
             return false;
         }
 
         if (mode == AccessMode::Create) {
-            return PlacementDataObject<DTYPE>(dtype, span, mode);
+            return PlacementDataObject<DTYPE, SPAN>();
         }
         return true;
     }
 
+    // Ends registration. Droppable data that no other user reads or writes is
+    // dropped and reported, and data read without a creator is reported.
+    // Given the order processors run in, Frame data whose live intervals do
+    // not overlap shares arena bytes. Arenas are then packed into their final
+    // layout, and from then on slots, arenas and the access matrix are never
+    // written again, so any thread may look them up without synchronization.
+    // That holds for these lookup tables only: the first touch of lazy data
+    // and Create of shared Frame data still change state and must not race,
+    // while dirty bits and span epochs are atomic.
+    void Seal(const ProcessorOrder& order = ProcessorOrder());
+
+    bool IsSealed() const {
+        return sealed_;
+    }
+
+    // Footprint of every span as laid out by Seal, empty before it. Seal also
+    // writes it as JSON to the file named by ADS_DTF_MEMORY_REPORT when set.
+    const MemoryPlan& GetMemoryPlan() const {
+        return plan_;
+    }
+
+    // objects visited versus skipped by the last reset of a span
+    struct ResetStats {
+        std::size_t cleared{0};
+        std::size_t skipped{0};
+    };
+
+    const Arena& GetArena(LifeSpan span) const {
+        return repos_[enum_id_cast(span)].GetArena();
+    }
+
+    const ResetStats& GetResetStats(LifeSpan span) const {
+        return repos_[enum_id_cast(span)].GetResetStats();
+    }
+
+    // coverage of the huge page backed data of a span
+    struct HugePageReport {
+        std::size_t mappedBytes{0};
+        std::size_t hugePageBytes{0};
+        std::size_t lockedBytes{0};
+    };
+
+    HugePageReport GetHugePageReport(LifeSpan span) const {
+        return repos_[enum_id_cast(span)].GetHugePageReport();
+    }
+
+    // RCU versions replaced and not freed yet, a Frame reset frees those no
+    // reader that was already reading before them still reads
+    std::size_t GetRetiredVersions() const {
+        return retired_.Size();
+    }
+
+    // Moves every data object onto the NUMA node of the processor that creates
+    // it, or of a writer when its creator is not mapped. Call it once the
+    // registrations are done and before Seal, it relocates the objects.
+    // Immovable data stays where it was placed.
+    void PlaceOnNodes(const NumaNodeMap& nodeMap);
+
+    template<typename DTYPE, LifeSpan SPAN>
+    int NumaNodeOf() const {
+        return repos_[enum_id_cast(SPAN)].NodeAt(DataSlot<DTYPE, SPAN>::index);
+    }
+
 private:
-    struct DataObjectBase {
-        virtual ~DataObjectBase() = default;
-        virtual void* Alloc() = 0;
-        virtual void Destroy() = 0;
-        virtual void Clear() = 0;
-        virtual void TryConstruct() = 0;
-        virtual bool HasConstructed() const = 0;
-        virtual bool IsConstructable() const = 0;
+    // Operations the repo applies to a type erased data object. One constant
+    // record per data type, objects themselves carry no vtable.
+    struct DataOps {
+        void (*clear)(void* object);
+        void* (*moveTo)(void* object, void* memory);
+        void (*destroy)(void* object);
+        void (*create)(void* memory, std::uint32_t epoch);
     };
 
-    template<typename DTYPE>
-    struct DataObjectPlacement : public DataObjectBase {
+    template<typename DTYPE, LifeSpan SPAN>
+    struct DataObjectPlacement {
+        static constexpr std::size_t capacity = DtypeInfo<DTYPE, SPAN>::capacity;
+        static constexpr std::size_t depth = DtypeInfo<DTYPE, SPAN>::history;
+        static_assert(capacity > 0, "Invalid capacity");
+        static_assert(depth > 0, "Invalid history depth");
+
+        // epoch reset data is never visited by a reset, it goes stale when the
+        // span epoch moves on and is destroyed lazily by the next Create
+        static constexpr bool epochReset = has_option(DtypeInfo<DTYPE, SPAN>::options, DataOption::EpochReset);
+        static_assert(!(epochReset && depth > 1), "History data rotates on reset, it can not use epoch reset");
+
+        // Create refills a live object through its reset(args...) hook or by
+        // assignment instead of destroying it, so its heap capacity stays warm
+        static constexpr bool reuseOnCreate = has_option(DtypeInfo<DTYPE, SPAN>::options, DataOption::ReuseOnCreate);
+
+        // lazy data is constructed on its first use instead of at registration,
+        // so a type a deployment never touches costs neither time nor pages
+        static constexpr bool lazy = has_option(DtypeInfo<DTYPE, SPAN>::options, DataOption::Lazy);
+
+        // sync data is shared by processors on several threads, each cell
+        // carries a reader-writer lock that every access holds
+        static constexpr bool sync = DtypeInfo<DTYPE, SPAN>::sync;
+        static_assert(!(sync && lazy), "Lazy data is constructed without a lock, it can not be sync");
+        static_assert(!(sync && depth > 1), "History data rotates on reset, it can not be sync");
+
+        // small trivially copyable sync data may use a seqlock instead, readers
+        // copy it out without blocking and writers publish a private copy
+        static constexpr bool seqLock = has_option(DtypeInfo<DTYPE, SPAN>::options, DataOption::SeqLock);
+        static_assert(!seqLock || sync, "Seqlock data must be registered as sync");
+        static_assert(!seqLock || std::is_trivially_copyable<DTYPE>::value, "Seqlock data must be trivially copyable");
+        static_assert(!(seqLock && epochReset), "Seqlock readers only check presence, it can not use epoch reset");
+
+        // RCU data is read through an atomic pointer to its current version,
+        // writers publish a new heap version and the old one is retired until
+        // a frame boundary no reader holds a version across; cells keep no data
+        static constexpr bool rcu = has_option(DtypeInfo<DTYPE, SPAN>::options, DataOption::Rcu);
+        static_assert(!rcu || (sync && SPAN == LifeSpan::Global), "RCU data must be registered as sync Global data");
+        static_assert(!rcu || std::is_copy_constructible<DTYPE>::value, "RCU writers copy the version, it must be copy constructible");
+        static_assert(!(rcu && (seqLock || epochReset || reuseOnCreate)), "Invalid DataOption of RCU data");
+        static_assert(!(rcu && (has_option(DtypeInfo<DTYPE, SPAN>::options, DataOption::HugePage) ||
+                                has_option(DtypeInfo<DTYPE, SPAN>::options, DataOption::MemoryLock))), "RCU versions live on the heap");
+
+        // mailboxes and streams synchronize themselves, so their users may fetch
+        // them from their own threads; they keep their contents across frames
+        static constexpr bool channel = is_mailbox<DTYPE>::value || is_stream<DTYPE>::value;
+        static_assert(!(channel && (SPAN == LifeSpan::Frame || lazy || depth > 1)), "A mailbox or stream must be eager Cache or Global data");
+        static_assert(!(channel && sync), "A mailbox or stream synchronizes itself, it can not be sync");
+
+        // its creator never reads it back, Seal drops it when no one else uses it
+        static constexpr bool droppable = has_option(DtypeInfo<DTYPE, SPAN>::options, DataOption::Droppable);
+
+        // writes mark the slot for the next reset, except where that would race
+        static constexpr bool marksDirty = !epochReset && !channel;
+
+        // data that may give its bytes to other data outside its live interval,
+        // it is built afresh each frame so nothing it keeps across frames survives
+        static constexpr bool shareable = (depth == 1) && !epochReset && !reuseOnCreate && !sync && !channel;
+
+        static constexpr std::string_view name = TypeNameOf<DTYPE>();
+        static constexpr std::size_t dataSize = sizeof(DTYPE);
+        static constexpr std::size_t dataAlign = alignof(DTYPE);
+        // bytes one instance takes in the object, RCU versions live on the heap
+        static constexpr std::size_t storedSize = rcu ? 0 : sizeof(DTYPE);
+
+        // types with no clear method and no history need no work on reset,
+        // the repo only counts them instead of visiting each object
+        // a reset leaves RCU data alone, readers may still hold its version
+        static constexpr bool clearable = !rcu && ((depth > 1) || has_any_clear<DTYPE>::value);
+
+        // the arena moves its objects when it grows, on Seal and onto NUMA nodes,
+        // data that can not be moved without losing state gets storage of its own
+        static constexpr bool movable = rcu || std::is_nothrow_move_constructible<DTYPE>::value;
+
+        // mirrors the choice auto_construct makes at run time
+        static constexpr bool constructable = std::is_default_constructible<DTYPE>::value || std::is_pointer<DTYPE>::value;
+
         DataObjectPlacement() = default;
 
-        void* Alloc() override {
-            constructed_ = true;
-            return placement.Alloc();
+        ~DataObjectPlacement() {
+            for (auto& cell : cells) {
+                if constexpr (rcu) {
+                    delete cell.version.load(std::memory_order_relaxed);
+                } else if (cell.constructed) {
+                    cell.placement.Destroy();
+                }
+            }
+        }
+
+        void* Alloc(std::size_t instance) {
+            auto& cell = Current(instance);
+            cell.constructed = true;
+            return cell.placement.Alloc();
+        }
+
+        void Destroy(std::size_t instance) {
+            auto& cell = Current(instance);
+            cell.placement.Destroy();
+            cell.constructed = false;
+        }
+
+        void Clear() {
+            if constexpr (!rcu) {
+                if (pending_) {
+                    return;
+                }
+                if (depth > 1) {
+                    Rotate();
+                    return;
+                }
+                for (auto& cell : cells) {
+                    if constexpr (seqLock) {
+                        std::unique_lock<std::mutex> writer(cell.seqLock.Writer());
+                        if (cell.constructed) {
+                            OptionalPtr<DTYPE, SyncMode::SeqLock> dataPtr(std::move(writer), cell.seqLock, *cell.placement.GetPointer(), cell.constructed);
+                            auto_clear(dataPtr.Get());
+                        }
+                    } else {
+                        auto lock = LockOf(cell);
+                        if (cell.constructed) {
+                            auto_clear(cell.placement.GetPointer());
+                        }
+                    }
+                }
+            }
+        }
+
+        bool HasConstructed(std::size_t instance) const {
+            return Current(instance).constructed;
+        }
+
+        bool IsConstructable() const {
+            return constructable;
         }
 
-        void Destroy() override {
-            placement.Destroy();
-            constructed_ = false;
+        void TryConstruct() {
+            for (std::size_t i = 0; i < capacity; i++) {
+                auto& cell = Current(i);
+                cell.constructed = auto_construct(cell.placement.GetPointer());
+            }
         }
 
-        void Clear() override {
-            if (constructed_) {
-                auto_clear(placement.GetPointer());
+        // default constructs every instance as of the given span epoch
+        void Construct(std::uint32_t epoch) {
+            if constexpr (rcu) {
+                if constexpr (std::is_default_constructible<DTYPE>::value) {
+                    for (std::size_t i = 0; i < capacity; i++) {
+                        Current(i).version.store(new DTYPE(), std::memory_order_release);
+                    }
+                }
+            } else {
+                TryConstruct();
+            }
+            for (std::size_t i = 0; i < capacity; i++) {
+                Current(i).epoch = epoch;
             }
+            pending_ = false;
+        }
+
+        DataObjectPlacement* MoveTo(void* memory) {
+            auto dataObjPtr = new (memory) DataObjectPlacement<DTYPE, SPAN>;
+            for (std::size_t i = 0; i < capacity * depth; i++) {
+                if constexpr (rcu) {
+                    dataObjPtr->cells[i].version.store(cells[i].version.exchange(nullptr));
+                } else if (cells[i].constructed) {
+                    dataObjPtr->cells[i].constructed = Relocate(cells[i].placement.GetPointer(), dataObjPtr->cells[i].placement.Alloc());
+                    dataObjPtr->cells[i].epoch = cells[i].epoch;
+                    cells[i].constructed = false;
+                }
+            }
+            dataObjPtr->head_ = head_;
+            dataObjPtr->pending_ = pending_;
+            this->~DataObjectPlacement();
+            return dataObjPtr;
+        }
+
+        // isolated data starts on its own cache line and pads up to the next one,
+        // so writers of neighbouring objects never share a line with it
+        static constexpr bool isolated = has_option(DtypeInfo<DTYPE, SPAN>::options, DataOption::CacheLineIsolated);
+        static constexpr std::size_t storedAlign = rcu ? alignof(DTYPE*) : alignof(Placement<DTYPE>);
+        static constexpr std::size_t alignment = isolated ? std::max(CACHE_LINE_SIZE, storedAlign) : storedAlign;
+
+        struct NoLock {};
+        struct SharedLock {
+            mutable std::shared_timed_mutex mutex;
+        };
+        struct SequenceLock {
+            SeqLock seqLock;
+        };
+        struct RcuVersion {
+            std::atomic<DTYPE*> version{nullptr};
+            std::mutex writer;
+        };
+        using CellLock = std::conditional_t<rcu, RcuVersion,
+                         std::conditional_t<seqLock, SequenceLock,
+                         std::conditional_t<sync, SharedLock, NoLock>>>;
+
+        struct NoStorage {};
+        struct InlineStorage {
+            Placement<DTYPE> placement;
+        };
+        using CellStorage = std::conditional_t<rcu, NoStorage, InlineStorage>;
+
+        struct alignas(alignment) Cell : CellLock, CellStorage {
+            bool constructed{false};
+            // wraps after 2^32 resets, only a cell untouched for exactly that long is misjudged
+            std::uint32_t epoch{0};
+        };
+
+        // exclusive hold on the cell of locked sync data, an empty lock for other data
+        static std::unique_lock<std::shared_timed_mutex> LockOf(Cell& cell) {
+            if constexpr (std::is_same<CellLock, SharedLock>::value) {
+                return std::unique_lock<std::shared_timed_mutex>(cell.mutex);
+            } else {
+                return std::unique_lock<std::shared_timed_mutex>();
+            }
+        }
+
+        static bool IsLive(const Cell& cell, std::uint32_t epoch) {
+            return cell.constructed && (!epochReset || cell.epoch == epoch);
+        }
+
+        // each instance owns a ring of depth cells, head_ is the current frame
+        const Cell& AtAge(std::size_t instance, std::size_t age) const {
+            return cells[instance * depth + (head_ + depth - age) % depth];
         }
 
-        bool HasConstructed() const override {
-            return constructed_;
+        Cell& Current(std::size_t instance) {
+            return cells[instance * depth + head_];
         }
 
-        bool IsConstructable() const override {
-            return defaultConstructable_;
+        const Cell& Current(std::size_t instance) const {
+            return cells[instance * depth + head_];
         }
 
-        void TryConstruct() override {
-            constructed_ = auto_construct(placement.GetPointer());
-            defaultConstructable_ = constructed_;            
+        Cell cells[capacity * depth];
+        std::size_t head_{0};
+        bool pending_{lazy};
+
+        // bytes kept beside the instances, each cell's lock, flag and epoch and
+        // the ring head; whatever else the object takes is alignment padding
+        static constexpr std::size_t bookkeeping =
+            capacity * depth * ((std::is_empty<CellLock>::value ? 0 : sizeof(CellLock)) + sizeof(bool) + sizeof(std::uint32_t)) +
+            sizeof(std::size_t) + sizeof(bool);
+
+        static constexpr DataOps ops = {
+            [](void* object) { static_cast<DataObjectPlacement*>(object)->Clear(); },
+            [](void* object, void* memory) -> void* { return static_cast<DataObjectPlacement*>(object)->MoveTo(memory); },
+            [](void* object) { static_cast<DataObjectPlacement*>(object)->~DataObjectPlacement(); },
+            [](void* memory, std::uint32_t epoch) { (new (memory) DataObjectPlacement)->Construct(epoch); },
+        };
+
+    private:
+        // the oldest frame is recycled as the current one, it stays absent
+        // until the next Create so a skipped frame never reads as a fresh one
+        void Rotate() {
+            head_ = (head_ + 1) % depth;
+            for (std::size_t i = 0; i < capacity; i++) {
+                auto& cell = Current(i);
+                if (cell.constructed) {
+                    cell.placement.Destroy();
+                    cell.constructed = false;
+                }
+            }
         }
 
-        Placement<DTYPE> placement;
-        bool constructed_{false};
-        bool defaultConstructable_{false};
+        static bool Relocate(DTYPE* from, void* to) {
+            if constexpr (movable) {
+                new (to) DTYPE(std::move(*from));
+                from->~DTYPE();
+                return true;
+            } else {
+                assert(false && "Immovable data lives in fixed storage, it is never relocated");
+                return false;
+            }
+        }
     };
 
-    template <typename DTYPE>
-    bool PlacementDataObject(DataType dtype, LifeSpan span, AccessMode mode) {
+    // All data objects of one LifeSpan live back to back in one arena,
+    // objects_ maps the dense slot index to the object inside it.
+    struct DataRepo {
+        DataRepo() = default;
+        ~DataRepo();
 
-        if (span >= LifeSpan::Max) return false;
+        DataRepo(const DataRepo&) = delete;
+        DataRepo& operator=(const DataRepo&) = delete;
 
-        DataRepo& repo = repos_[enum_id_cast(span)];
-        auto result = repo.find(dtype);
-        if (result != repo.end()) {
-            return false;
+        template<typename OBJECT>
+        OBJECT* Emplace(SlotIndex slot, DataType dtype) {
+            if (slot >= objects_.size()) {
+                objects_.resize(slot + 1, nullptr);
+            }
+            if (objects_[slot]) {
+                return nullptr;
+            }
+
+            std::size_t align = alignof(OBJECT);
+            std::size_t offset = align_up(used_, align);
+            std::size_t end = offset + sizeof(OBJECT);
+            if (!arena_.Fits(end, align)) {
+                if (!Reallocate(std::max(end, arena_.Capacity() * 2), std::max(align, arena_.Alignment()))) {
+                    return nullptr;
+                }
+            }
+
+            // default initialized, value initialization would zero every cell
+            auto object = new (arena_.Data() + offset) OBJECT;
+            used_ = end;
+            Bind(slot, object, &OBJECT::ops, OBJECT::clearable, LayoutOf<OBJECT>(dtype, OBJECT::shareable));
+            return object;
+        }
+
+        // large data gets a huge page backed mapping of its own instead of arena bytes
+        template<typename OBJECT>
+        OBJECT* EmplaceMapped(SlotIndex slot, DataType dtype, bool lock) {
+            if (slot >= objects_.size()) {
+                objects_.resize(slot + 1, nullptr);
+            }
+            if (objects_[slot]) {
+                return nullptr;
+            }
+
+            MappedRegion region(sizeof(OBJECT), lock);
+            if (!region.Data()) {
+                return nullptr;
+            }
+
+            auto object = new (region.Data()) OBJECT;
+            regions_.push_back(std::move(region));
+            Bind(slot, object, &OBJECT::ops, OBJECT::clearable, LayoutOf<OBJECT>(dtype, false));
+            return object;
+        }
+
+        // immovable data gets a block of its own that nothing ever relocates
+        template<typename OBJECT>
+        OBJECT* EmplaceFixed(SlotIndex slot, DataType dtype) {
+            if (slot >= objects_.size()) {
+                objects_.resize(slot + 1, nullptr);
+            }
+            if (objects_[slot]) {
+                return nullptr;
+            }
+
+            Arena block(sizeof(OBJECT), alignof(OBJECT));
+            if (!block.Data()) {
+                return nullptr;
+            }
+
+            auto object = new (block.Data()) OBJECT;
+            fixed_.push_back(std::move(block));
+            Bind(slot, object, &OBJECT::ops, OBJECT::clearable, LayoutOf<OBJECT>(dtype, false));
+            return object;
+        }
+
+        bool IsFixed(SlotIndex slot) const {
+            return std::any_of(fixed_.begin(), fixed_.end(), [this, slot](const Arena& block) {
+                return block.Data() == static_cast<char*>(objects_[slot]);
+            });
+        }
+
+        HugePageReport GetHugePageReport() const {
+            HugePageReport report;
+            for (auto& region : regions_) {
+                report.mappedBytes += region.Size();
+                report.hugePageBytes += region.HugePageBytes();
+                report.lockedBytes += region.Locked() ? region.Size() : 0;
+            }
+            return report;
+        }
+
+        void* At(SlotIndex slot) const {
+            return (slot < objects_.size()) ? objects_[slot] : nullptr;
+        }
+
+        std::size_t SlotCount() const {
+            return objects_.size();
+        }
+
+        DataType TypeAt(SlotIndex slot) const {
+            return layouts_[slot].dtype;
+        }
+
+        int NodeAt(SlotIndex slot) const {
+            return (slot < layouts_.size()) ? layouts_[slot].node : NUMA_NODE_ANY;
+        }
+
+        // moves each object to an arena bound to requested[slot], NUMA_NODE_ANY leaves it in place
+        void PlaceOnNodes(const std::vector<int>& requested);
+
+        std::uint32_t Epoch() const {
+            return epoch_.load(std::memory_order_relaxed);
+        }
+
+        // processors on several threads may mark slots of one word at once
+        void MarkDirty(SlotIndex slot) {
+            dirty_.Set(slot);
+        }
+
+        // pinned objects are visited on every reset, whether written or not
+        void MarkPinned(SlotIndex slot) {
+            pinned_.Set(slot);
+        }
+
+        const ResetStats& GetResetStats() const {
+            return lastReset_;
+        }
+
+        std::size_t Size() const {
+            return used_;
+        }
+
+        const Arena& GetArena() const {
+            return arena_;
+        }
+
+        void Reset();
+
+        // Packs the objects left in the arena back to back and stops further
+        // growth. The slots of each group share one block sized for the largest.
+        // Immovable data sits in fixed blocks outside the arena and keeps its place.
+        void Seal(const std::vector<std::vector<SlotIndex>>& groups);
+
+        // arena objects that may share bytes, the candidates for Seal groups
+        bool IsShareable(SlotIndex slot) const {
+            return objects_[slot] && layouts_[slot].shareable && arena_.Contains(objects_[slot]);
+        }
+
+        std::size_t SizeAt(SlotIndex slot) const {
+            return layouts_[slot].size;
+        }
+
+        bool IsShared(SlotIndex slot) const {
+            return slot < shared_.Size() && shared_.Test(slot);
+        }
+
+        // The slot created last in a group owns its bytes: the previous owner
+        // is destroyed and the slot is default constructed in its place. Only
+        // Create moves ownership, a Fetch of a slot that lost it finds nothing.
+        void Acquire(SlotIndex slot) {
+            auto& owner = owners_[groupOf_[slot]];
+            if (owner == slot) return;
+            if (owner != INVALID_SLOT) {
+                ops_[owner]->destroy(objects_[owner]);
+            }
+            ops_[slot]->create(objects_[slot], Epoch());
+            owner = slot;
+        }
+
+        bool Owns(SlotIndex slot) const {
+            return owners_[groupOf_[slot]] == slot;
+        }
+
+        // destroys the object of a slot and gives up its storage
+        void Eliminate(SlotIndex slot);
+
+        // describes the sealed layout of the repo
+        void Plan(MemoryPlan::Span& plan) const;
+
+        bool IsEliminated(SlotIndex slot) const {
+            return slot < eliminated_.Size() && eliminated_.Test(slot);
         }
 
-        auto dataObjPtr = std::make_unique<DataObjectPlacement<DTYPE>>();
+        bool IsDroppable(SlotIndex slot) const {
+            return slot < objects_.size() && objects_[slot] && layouts_[slot].droppable;
+        }
+
+    private:
+        struct SlotLayout {
+            DataType dtype{nullptr};
+            std::size_t size{0};
+            std::size_t align{0};
+            int node{NUMA_NODE_ANY};
+            bool shareable{false};
+            bool droppable{false};
+            std::string_view name;
+            std::size_t dataSize{0};
+            std::size_t dataAlign{0};
+            std::size_t storedSize{0};
+            std::size_t bookkeeping{0};
+            std::size_t capacity{0};
+            std::size_t depth{0};
+        };
+
+        template<typename OBJECT>
+        static SlotLayout LayoutOf(DataType dtype, bool shareable) {
+            return SlotLayout{dtype, sizeof(OBJECT), alignof(OBJECT), NUMA_NODE_ANY, shareable, OBJECT::droppable,
+                              OBJECT::name, OBJECT::dataSize, OBJECT::dataAlign, OBJECT::storedSize, OBJECT::bookkeeping, OBJECT::capacity, OBJECT::depth};
+        }
+
+        void Bind(SlotIndex slot, void* object, const DataOps* ops, bool clearable, const SlotLayout& layout) {
+            objects_[slot] = object;
+            ops_.resize(objects_.size(), nullptr);
+            ops_[slot] = ops;
+            layouts_.resize(objects_.size());
+            layouts_[slot] = layout;
+            count_++;
+            dirty_.Resize(objects_.size());
+            pinned_.Resize(objects_.size());
+            clearable_.Resize(objects_.size());
+            eliminated_.Resize(objects_.size());
+            shared_.Resize(objects_.size());
+            if (clearable) {
+                clearable_.Set(slot);
+            }
+        }
+
+        bool Reallocate(std::size_t capacity, std::size_t alignment);
+
+    private:
+        std::vector<void*> objects_;
+        std::vector<const DataOps*> ops_;
+        Arena arena_;
+        std::vector<MappedRegion> regions_;
+        std::vector<Arena> fixed_;
+        std::vector<NodeRegion> nodeArenas_;
+        std::vector<SlotLayout> layouts_;
+        std::size_t used_{0};
+        std::size_t count_{0};
+        // moved on by Reset while sync and epoch reset accesses read it
+        std::atomic<std::uint32_t> epoch_{0};
+        AtomicBitset dirty_;
+        DynamicBitset pinned_;
+        DynamicBitset clearable_;
+        DynamicBitset eliminated_;
+        DynamicBitset shared_;
+        std::vector<std::size_t> groupOf_;
+        std::vector<SlotIndex> owners_;
+        ResetStats lastReset_;
+    };
+
+    template <typename DTYPE, LifeSpan SPAN>
+    bool PlacementDataObject() {
+        DataRepo& repo = repos_[enum_id_cast(SPAN)];
+
+        using DataObject = DataObjectPlacement<DTYPE, SPAN>;
+        constexpr DataOption options = DtypeInfo<DTYPE, SPAN>::options;
+
+        SlotIndex slot = DataSlot<DTYPE, SPAN>::Assign();
+        DataObject* dataObjPtr = nullptr;
+        if (has_option(options, DataOption::HugePage) || has_option(options, DataOption::MemoryLock)) {
+            dataObjPtr = repo.EmplaceMapped<DataObject>(slot, TypeIdOf<DTYPE>(), has_option(options, DataOption::MemoryLock));
+        } else if (!DataObject::movable) {
+            dataObjPtr = repo.EmplaceFixed<DataObject>(slot, TypeIdOf<DTYPE>());
+        } else {
+            dataObjPtr = repo.Emplace<DataObject>(slot, TypeIdOf<DTYPE>());
+        }
         if (!dataObjPtr) {
             return false;
         }
 
-        dataObjPtr->TryConstruct();
+        // sync writes are not tracked, such data is visited on every reset
+        // unless it goes stale by epoch instead
+        if (DtypeInfo<DTYPE, SPAN>::history > 1 || (DataObject::sync && !DataObject::epochReset)) {
+            repo.MarkPinned(slot);
+        }
 
-        repo.emplace(dtype, std::move(dataObjPtr));
+        if (!DataObject::lazy) {
+            dataObjPtr->Construct(repo.Epoch());
+        }
         return true;
     }
 
 private:
-    using DataRepo = std::unordered_map<DataType, std::unique_ptr<DataObjectBase>>;
+    // the registered mode must match the compile time permission, a user whose
+    // registration has not run yet is refused
+    template<typename USER, typename DTYPE, LifeSpan SPAN>
+    bool HasAccess() const {
+        if constexpr (ENABLE_ACCESS_CONTROL) {
+            if (acl_.GetAccessModeAt(UserSlot<USER>::index, SPAN, DataSlot<DTYPE, SPAN>::index) != Permission<USER, DTYPE, SPAN>::mode) {
+                std::cout << "Access denied to dtype: " << TypeIdOf<DTYPE>() << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
 
-    template<typename DTYPE>
-    const DTYPE* GetDataPtr(const DataRepo& repo, DataType dtype) const {
-        auto result = repo.find(dtype);
-        if (result == repo.end()) {
+    // every access path goes through here, so lazy data is constructed on the
+    // first one; that first access must not race with others to the same data.
+    // Shared data is found only while its slot owns the bytes of its group.
+    template<typename DTYPE, LifeSpan SPAN>
+    DataObjectPlacement<DTYPE, SPAN>* GetDataObject() const {
+        auto& repo = repos_[enum_id_cast(SPAN)];
+        auto dataObjPtr = static_cast<DataObjectPlacement<DTYPE, SPAN>*>(repo.At(DataSlot<DTYPE, SPAN>::index));
+        if constexpr (SPAN == LifeSpan::Frame && DataObjectPlacement<DTYPE, SPAN>::shareable) {
+            if (dataObjPtr && repo.IsShared(DataSlot<DTYPE, SPAN>::index) && !repo.Owns(DataSlot<DTYPE, SPAN>::index)) {
+                return nullptr;
+            }
+        }
+        if constexpr (DataObjectPlacement<DTYPE, SPAN>::lazy) {
+            if (dataObjPtr && dataObjPtr->pending_) {
+                dataObjPtr->Construct(repo.Epoch());
+            }
+        }
+        return dataObjPtr;
+    }
+
+    template<typename DTYPE, LifeSpan SPAN>
+    const DTYPE* GetDataPtr(std::size_t instance) const {
+        auto dataObjPtr = GetDataObject<DTYPE, SPAN>();
+        if (!dataObjPtr || instance >= DtypeInfo<DTYPE, SPAN>::capacity) {
             return nullptr;
         }
+        auto& cell = dataObjPtr->Current(instance);
+        return dataObjPtr->IsLive(cell, repos_[enum_id_cast(SPAN)].Epoch()) ? cell.placement.GetPointer() : nullptr;
+    }
+
+    // one entry of the pointer block of a BoundContext, a data object without
+    // history never moves once the manager is sealed. Its cell is only read on
+    // fetch, shared bytes may hold other data while the context is built.
+    template<typename DTYPE, LifeSpan SPAN>
+    struct BoundData {
+        DataObjectPlacement<DTYPE, SPAN>* object{nullptr};
+        DataRepo* repo{nullptr};
+        bool shared{false};
+    };
+
+    template<typename USER, typename DTYPE, LifeSpan SPAN>
+    BoundData<DTYPE, SPAN> BindData() {
+        static_assert(SPAN < LifeSpan::Max, "Invalid LifeSpan");
+        static_assert(Permission<USER, DTYPE, SPAN>::mode != AccessMode::None, "Invalid AccessMode");
+        static_assert(!DtypeInfo<DTYPE, SPAN>::sync, "Invalid Sync");
+        static_assert(DtypeInfo<DTYPE, SPAN>::history == 1, "History data rotates, fetch it through DataContext");
+        static_assert(DtypeInfo<DTYPE, SPAN>::capacity == 1, "Only the first instance is bound, fetch it through DataContext");
 
-        if (!result->second->HasConstructed()) {
+        if (!sealed_) {
+            std::cout << "Bind data before sealing, dtype: " << TypeIdOf<DTYPE>() << std::endl;
+            return BoundData<DTYPE, SPAN>();
+        }
+
+        // shared data is bound whether its slot owns the bytes now or not
+        DataRepo& repo = repos_[enum_id_cast(SPAN)];
+        auto dataObjPtr = static_cast<DataObjectPlacement<DTYPE, SPAN>*>(repo.At(DataSlot<DTYPE, SPAN>::index));
+        if (!dataObjPtr || !HasAccess<USER, DTYPE, SPAN>()) {
+            return BoundData<DTYPE, SPAN>();
+        }
+        return BoundData<DTYPE, SPAN>{dataObjPtr, &repo, repo.IsShared(DataSlot<DTYPE, SPAN>::index)};
+    }
+
+    template<typename USER, typename DTYPE, LifeSpan SPAN>
+    DTYPE* FetchBound(const BoundData<DTYPE, SPAN>& bound) {
+        using DataObject = DataObjectPlacement<DTYPE, SPAN>;
+        if (!bound.object || (bound.shared && !bound.repo->Owns(DataSlot<DTYPE, SPAN>::index))) {
+            return nullptr;
+        }
+        // one instance and no history, its only cell is the current one
+        auto& cell = bound.object->cells[0];
+        if (!DataObject::IsLive(cell, bound.repo->Epoch())) {
             return nullptr;
         }
-        auto dataObjPtr = static_cast<DataObjectPlacement<DTYPE>*>(result->second.get());
-        return dataObjPtr->placement.GetPointer();
+        if (Permission<USER, DTYPE, SPAN>::mode != AccessMode::Read && DataObject::marksDirty) {
+            bound.repo->MarkDirty(DataSlot<DTYPE, SPAN>::index);
+        }
+        return cell.placement.GetPointer();
+    }
+
+    template<typename USER, typename DTYPE, LifeSpan SPAN>
+    DataHistory<DTYPE, DtypeInfo<DTYPE, SPAN>::history> History(std::size_t instance = 0) const {
+        static_assert(SPAN < LifeSpan::Max, "Invalid LifeSpan");
+        static_assert(Permission<USER, DTYPE, SPAN>::mode != AccessMode::None, "Invalid AccessMode");
+        static_assert(!DtypeInfo<DTYPE, SPAN>::sync, "Invalid Sync");
+
+        auto dataObjPtr = HasAccess<USER, DTYPE, SPAN>() ? GetDataObject<DTYPE, SPAN>() : nullptr;
+        return DataHistory<DTYPE, DtypeInfo<DTYPE, SPAN>::history>([dataObjPtr, instance](std::size_t age) -> const DTYPE* {
+            if (!dataObjPtr || instance >= DtypeInfo<DTYPE, SPAN>::capacity) {
+                return nullptr;
+            }
+            auto& cell = dataObjPtr->AtAge(instance, age);
+            return cell.constructed ? cell.placement.GetPointer() : nullptr;
+        });
     }
 
     template<typename USER, typename DTYPE, LifeSpan SPAN>
     typename std::enable_if<return_optional_ptr<USER, DTYPE, SPAN>::value, OptionalPtr<DTYPE, SyncMode::None>>::type
-    Fetch() {
+    Fetch(std::size_t instance = 0) {
         static_assert(SPAN < LifeSpan::Max, "Invalid LifeSpan");
         static_assert((Permission<USER, DTYPE, SPAN>::mode == AccessMode::Write) || 
                       (Permission<USER, DTYPE, SPAN>::mode == AccessMode::Create), "Invalid AccessMode");
         static_assert(!DtypeInfo<DTYPE, SPAN>::sync, "Invalid Sync");
 
-        return OptionalPtr<DTYPE, SyncMode::None>(const_cast<DTYPE*>(GetDataPtr<DTYPE>(repos_[enum_id_cast(SPAN)], TypeIdOf<DTYPE>()))); 
+        if (!HasAccess<USER, DTYPE, SPAN>()) {
+            return OptionalPtr<DTYPE, SyncMode::None>(nullptr);
+        }
+
+        auto dataPtr = const_cast<DTYPE*>(GetDataPtr<DTYPE, SPAN>(instance));
+        if (dataPtr && DataObjectPlacement<DTYPE, SPAN>::marksDirty) {
+            repos_[enum_id_cast(SPAN)].MarkDirty(DataSlot<DTYPE, SPAN>::index);
+        }
+        return OptionalPtr<DTYPE, SyncMode::None>(dataPtr);
     }
 
     template<typename USER, typename DTYPE, LifeSpan SPAN>
     typename std::enable_if<return_const_optional_ptr<USER, DTYPE, SPAN>::value, OptionalPtr<const DTYPE, SyncMode::None>>::type
-    Fetch() const {
+    Fetch(std::size_t instance = 0) const {
         static_assert(SPAN < LifeSpan::Max, "Invalid LifeSpan");
         static_assert(Permission<USER, DTYPE, SPAN>::mode == AccessMode::Read, "Invalid AccessMode");
         static_assert(!DtypeInfo<DTYPE, SPAN>::sync, "Invalid Sync");
 
-        return OptionalPtr<const DTYPE, SyncMode::None>(GetDataPtr<DTYPE>(repos_[enum_id_cast(SPAN)], TypeIdOf<DTYPE>()));
+        if (!HasAccess<USER, DTYPE, SPAN>()) {
+            return OptionalPtr<const DTYPE, SyncMode::None>(nullptr);
+        }
+        return OptionalPtr<const DTYPE, SyncMode::None>(GetDataPtr<DTYPE, SPAN>(instance));
+    }
+
+    // the creator and writers of a stream push through a producer handle
+    template<typename USER, typename DTYPE, LifeSpan SPAN>
+    typename std::enable_if<return_stream_producer<USER, DTYPE, SPAN>::value, typename DTYPE::Producer>::type
+    Fetch(std::size_t instance = 0) {
+        static_assert(SPAN < LifeSpan::Max, "Invalid LifeSpan");
+        static_assert((Permission<USER, DTYPE, SPAN>::mode == AccessMode::Write) || 
+                      (Permission<USER, DTYPE, SPAN>::mode == AccessMode::Create), "Invalid AccessMode");
+
+        if (!HasAccess<USER, DTYPE, SPAN>()) {
+            return typename DTYPE::Producer(nullptr);
+        }
+        return typename DTYPE::Producer(const_cast<DTYPE*>(GetDataPtr<DTYPE, SPAN>(instance)));
+    }
+
+    // and the readers of a stream or a mailbox take through a consumer handle
+    template<typename USER, typename DTYPE, LifeSpan SPAN>
+    typename std::enable_if<return_channel_consumer<USER, DTYPE, SPAN>::value, typename DTYPE::Consumer>::type
+    Fetch(std::size_t instance = 0) const {
+        static_assert(SPAN < LifeSpan::Max, "Invalid LifeSpan");
+        static_assert(Permission<USER, DTYPE, SPAN>::mode == AccessMode::Read, "Invalid AccessMode");
+
+        if (!HasAccess<USER, DTYPE, SPAN>()) {
+            return typename DTYPE::Consumer(nullptr);
+        }
+        return typename DTYPE::Consumer(const_cast<DTYPE*>(GetDataPtr<DTYPE, SPAN>(instance)));
     }
 
     template<typename USER, typename DTYPE, LifeSpan SPAN, typename ...ARGs>
     typename std::enable_if<return_optional_ptr<USER, DTYPE, SPAN>::value, OptionalPtr<DTYPE, SyncMode::None>>::type
-    Create(ARGs&& ...args) {
+    Create(std::size_t instance, ARGs&& ...args) {
         static_assert(SPAN < LifeSpan::Max, "Invalid LifeSpan");
         static_assert(Permission<USER, DTYPE, SPAN>::mode == AccessMode::Create, "Invalid AccessMode");
         static_assert(!DtypeInfo<DTYPE, SPAN>::sync, "Invalid Sync");
 
-        DataType dtype = TypeIdOf<DTYPE>();
+        if (!HasAccess<USER, DTYPE, SPAN>()) {
+            return OptionalPtr<DTYPE, SyncMode::None>(nullptr);
+        }
 
-        DataRepo& repo = repos_[enum_id_cast(SPAN)];
-        auto result = repo.find(dtype);
-        if (result == repo.end()) {
-            std::cout << "Failed to find dtype: " << dtype << std::endl;
+        // creating shared data takes over the bytes of its group
+        if constexpr (SPAN == LifeSpan::Frame && DataObjectPlacement<DTYPE, SPAN>::shareable) {
+            DataRepo& repo = repos_[enum_id_cast(SPAN)];
+            if (repo.At(DataSlot<DTYPE, SPAN>::index) && repo.IsShared(DataSlot<DTYPE, SPAN>::index)) {
+                repo.Acquire(DataSlot<DTYPE, SPAN>::index);
+            }
+        }
+
+        auto dataObjPtr = GetDataObject<DTYPE, SPAN>();
+        if (!dataObjPtr && repos_[enum_id_cast(SPAN)].IsEliminated(DataSlot<DTYPE, SPAN>::index)) {
+            std::cout << "Dropped at seal, nobody reads dtype: " << TypeIdOf<DTYPE>() << std::endl;
             return OptionalPtr<DTYPE, SyncMode::None>(nullptr);
         }
+        if (!dataObjPtr) {
+            std::cout << "Failed to find dtype: " << TypeIdOf<DTYPE>() << std::endl;
+            return OptionalPtr<DTYPE, SyncMode::None>(nullptr);
+        }
+
+        if (instance >= DtypeInfo<DTYPE, SPAN>::capacity) {
+            std::cout << "Invalid instance " << instance << " of dtype: " << TypeIdOf<DTYPE>() << std::endl;
+            return OptionalPtr<DTYPE, SyncMode::None>(nullptr);
+        }
+
+        // a mailbox lives from registration on and users on other threads may
+        // hold it, creating it hands out the live instance untouched
+        if constexpr (DataObjectPlacement<DTYPE, SPAN>::channel) {
+            static_assert(sizeof...(ARGs) == 0, "A mailbox is constructed at registration, Create takes no arguments");
+            auto& cell = dataObjPtr->Current(instance);
+            return OptionalPtr<DTYPE, SyncMode::None>(cell.constructed ? cell.placement.GetPointer() : nullptr);
+        }
 
-        if (result->second->HasConstructed()) {
-            result->second->Destroy();
+        DataRepo& repo = repos_[enum_id_cast(SPAN)];
+        if (DataObjectPlacement<DTYPE, SPAN>::epochReset) {
+            dataObjPtr->Current(instance).epoch = repo.Epoch();
+        } else {
+            repo.MarkDirty(DataSlot<DTYPE, SPAN>::index);
         }
 
-        return OptionalPtr<DTYPE, SyncMode::None>(new (result->second->Alloc()) DTYPE(std::forward<ARGs>(args)...));
+        if (dataObjPtr->HasConstructed(instance)) {
+            if constexpr (DataObjectPlacement<DTYPE, SPAN>::reuseOnCreate) {
+                DTYPE* dataPtr = dataObjPtr->Current(instance).placement.GetPointer();
+                auto_reset(dataPtr, std::forward<ARGs>(args)...);
+                return OptionalPtr<DTYPE, SyncMode::None>(dataPtr);
+            }
+            dataObjPtr->Destroy(instance);
+        }
+
+        return OptionalPtr<DTYPE, SyncMode::None>(new (dataObjPtr->Alloc(instance)) DTYPE(std::forward<ARGs>(args)...));
     }
 
     template<typename USER, typename DTYPE, LifeSpan SPAN>
-    void Destroy(LifeSpan span) {
+    typename std::enable_if<return_sync_write_optional_ptr<USER, DTYPE, SPAN>::value, OptionalPtr<DTYPE, sync_mode_of<DTYPE, SPAN>::value>>::type
+    Fetch(std::size_t instance = 0) {
         static_assert(SPAN < LifeSpan::Max, "Invalid LifeSpan");
-        static_assert((Permission<USER, DTYPE, SPAN>::mode == AccessMode::Create), "Invalid AccessMode");
+        static_assert((Permission<USER, DTYPE, SPAN>::mode == AccessMode::Write) || 
+                      (Permission<USER, DTYPE, SPAN>::mode == AccessMode::Create), "Invalid AccessMode");
+        static_assert(DtypeInfo<DTYPE, SPAN>::sync, "Invalid Sync");
+
+        constexpr SyncMode MODE = sync_mode_of<DTYPE, SPAN>::value;
+        auto dataObjPtr = HasAccess<USER, DTYPE, SPAN>() ? GetDataObject<DTYPE, SPAN>() : nullptr;
+        if (!dataObjPtr || instance >= DtypeInfo<DTYPE, SPAN>::capacity) {
+            return OptionalPtr<DTYPE, MODE>(nullptr);
+        }
+
+        auto& cell = dataObjPtr->Current(instance);
+        if constexpr (MODE == SyncMode::SeqLock) {
+            std::unique_lock<std::mutex> writer(cell.seqLock.Writer());
+            if (!cell.constructed) {
+                return OptionalPtr<DTYPE, MODE>(nullptr);
+            }
+            return OptionalPtr<DTYPE, MODE>(std::move(writer), cell.seqLock, *cell.placement.GetPointer(), cell.constructed);
+        } else if constexpr (MODE == SyncMode::Rcu) {
+            std::unique_lock<std::mutex> writer(cell.writer);
+            DTYPE* current = cell.version.load(std::memory_order_relaxed);
+            if (!current) {
+                return OptionalPtr<DTYPE, MODE>(nullptr);
+            }
+            return OptionalPtr<DTYPE, MODE>(std::move(writer), new DTYPE(*current), cell.version, retired_);
+        } else {
+            OptionalPtr<DTYPE, MODE> dataPtr(cell.placement.GetPointer(), cell.mutex);
+            if (!dataObjPtr->IsLive(cell, repos_[enum_id_cast(SPAN)].Epoch())) {
+                return OptionalPtr<DTYPE, MODE>(nullptr);
+            }
+            return dataPtr;
+        }
+    }
+
+    template<typename USER, typename DTYPE, LifeSpan SPAN>
+    typename std::enable_if<return_sync_read_optional_ptr<USER, DTYPE, SPAN>::value, OptionalPtr<const DTYPE, sync_mode_of<DTYPE, SPAN>::value>>::type
+    Fetch(std::size_t instance = 0) const {
+        static_assert(SPAN < LifeSpan::Max, "Invalid LifeSpan");
+        static_assert(Permission<USER, DTYPE, SPAN>::mode == AccessMode::Read, "Invalid AccessMode");
+        static_assert(DtypeInfo<DTYPE, SPAN>::sync, "Invalid Sync");
+
+        constexpr SyncMode MODE = sync_mode_of<DTYPE, SPAN>::value;
+        auto dataObjPtr = HasAccess<USER, DTYPE, SPAN>() ? GetDataObject<DTYPE, SPAN>() : nullptr;
+        if (!dataObjPtr || instance >= DtypeInfo<DTYPE, SPAN>::capacity) {
+            return OptionalPtr<const DTYPE, MODE>(nullptr);
+        }
+
+        const auto& cell = dataObjPtr->Current(instance);
+        if constexpr (MODE == SyncMode::SeqLock) {
+            return OptionalPtr<const DTYPE, MODE>(cell.seqLock, *cell.placement.GetPointer(), cell.constructed);
+        } else if constexpr (MODE == SyncMode::Rcu) {
+            // wait-free, the version stays valid for as long as the reader keeps it
+            return OptionalPtr<const DTYPE, MODE>(cell.version, retired_);
+        } else {
+            OptionalPtr<const DTYPE, MODE> dataPtr(cell.placement.GetPointer(), cell.mutex);
+            if (!dataObjPtr->IsLive(cell, repos_[enum_id_cast(SPAN)].Epoch())) {
+                return OptionalPtr<const DTYPE, MODE>(nullptr);
+            }
+            return dataPtr;
+        }
+    }
+
+    // the returned pointer holds the cell exclusively from before the old
+    // object is destroyed until the caller is done filling the new one
+    template<typename USER, typename DTYPE, LifeSpan SPAN, typename ...ARGs>
+    typename std::enable_if<return_sync_write_optional_ptr<USER, DTYPE, SPAN>::value, OptionalPtr<DTYPE, sync_mode_of<DTYPE, SPAN>::value>>::type
+    Create(std::size_t instance, ARGs&& ...args) {
+        static_assert(SPAN < LifeSpan::Max, "Invalid LifeSpan");
+        static_assert(Permission<USER, DTYPE, SPAN>::mode == AccessMode::Create, "Invalid AccessMode");
+        static_assert(DtypeInfo<DTYPE, SPAN>::sync, "Invalid Sync");
+
+        constexpr SyncMode MODE = sync_mode_of<DTYPE, SPAN>::value;
+        if (!HasAccess<USER, DTYPE, SPAN>()) {
+            return OptionalPtr<DTYPE, MODE>(nullptr);
+        }
+
+        auto dataObjPtr = GetDataObject<DTYPE, SPAN>();
+        if (!dataObjPtr && repos_[enum_id_cast(SPAN)].IsEliminated(DataSlot<DTYPE, SPAN>::index)) {
+            std::cout << "Dropped at seal, nobody reads dtype: " << TypeIdOf<DTYPE>() << std::endl;
+            return OptionalPtr<DTYPE, MODE>(nullptr);
+        }
+        if (!dataObjPtr) {
+            std::cout << "Failed to find dtype: " << TypeIdOf<DTYPE>() << std::endl;
+            return OptionalPtr<DTYPE, MODE>(nullptr);
+        }
+
+        if (instance >= DtypeInfo<DTYPE, SPAN>::capacity) {
+            std::cout << "Invalid instance " << instance << " of dtype: " << TypeIdOf<DTYPE>() << std::endl;
+            return OptionalPtr<DTYPE, MODE>(nullptr);
+        }
 
-        DataType dtype = TypeIdOf<DTYPE>();
+        auto& cell = dataObjPtr->Current(instance);
+        if constexpr (MODE == SyncMode::SeqLock) {
+            // trivially copyable data needs no destruction, the new value is
+            // built in the private copy and replaces the old one on publish
+            std::unique_lock<std::mutex> writer(cell.seqLock.Writer());
+            bool constructed = cell.constructed;
+            OptionalPtr<DTYPE, MODE> dataPtr(std::move(writer), cell.seqLock, *cell.placement.GetPointer(), cell.constructed);
+            if constexpr (DataObjectPlacement<DTYPE, SPAN>::reuseOnCreate) {
+                if (constructed) {
+                    auto_reset(dataPtr.Get(), std::forward<ARGs>(args)...);
+                    return dataPtr;
+                }
+            }
+            new (dataPtr.Get()) DTYPE(std::forward<ARGs>(args)...);
+            return dataPtr;
+        } else if constexpr (MODE == SyncMode::Rcu) {
+            std::unique_lock<std::mutex> writer(cell.writer);
+            return OptionalPtr<DTYPE, MODE>(std::move(writer), new DTYPE(std::forward<ARGs>(args)...), cell.version, retired_);
+        } else {
+            OptionalPtr<DTYPE, MODE> dataPtr(cell.placement.GetPointer(), cell.mutex);
+            if (DataObjectPlacement<DTYPE, SPAN>::epochReset) {
+                cell.epoch = repos_[enum_id_cast(SPAN)].Epoch();
+            }
 
-        DataRepo& repo = repos_[enum_id_cast(span)];
-        auto result = repo.find(dtype);
-        if (result == repo.end()) {
+            if (cell.constructed) {
+                if constexpr (DataObjectPlacement<DTYPE, SPAN>::reuseOnCreate) {
+                    auto_reset(dataPtr.Get(), std::forward<ARGs>(args)...);
+                    return dataPtr;
+                }
+                dataObjPtr->Destroy(instance);
+            }
+
+            new (dataObjPtr->Alloc(instance)) DTYPE(std::forward<ARGs>(args)...);
+            return dataPtr;
+        }
+    }
+
+    template<typename USER, typename DTYPE, LifeSpan SPAN>
+    void Destroy(std::size_t instance = 0) {
+        static_assert(SPAN < LifeSpan::Max, "Invalid LifeSpan");
+        static_assert((Permission<USER, DTYPE, SPAN>::mode == AccessMode::Create), "Invalid AccessMode");
+
+        auto dataObjPtr = HasAccess<USER, DTYPE, SPAN>() ? GetDataObject<DTYPE, SPAN>() : nullptr;
+        if (!dataObjPtr || instance >= DtypeInfo<DTYPE, SPAN>::capacity) {
             return;
         }
 
-        if (result->second->HasConstructed()) {
-            result->second->Destroy();
+        auto& cell = dataObjPtr->Current(instance);
+        if constexpr (DataObjectPlacement<DTYPE, SPAN>::seqLock) {
+            std::unique_lock<std::mutex> writer(cell.seqLock.Writer());
+            cell.seqLock.WriteBegin();
+            __atomic_store_n(&cell.constructed, false, __ATOMIC_RELAXED);
+            cell.seqLock.WriteEnd();
+        } else if constexpr (DataObjectPlacement<DTYPE, SPAN>::rcu) {
+            std::unique_lock<std::mutex> writer(cell.writer);
+            DTYPE* previous = cell.version.exchange(nullptr, std::memory_order_acq_rel);
+            if (previous) {
+                retired_.Retire(previous);
+            }
+        } else {
+            auto lock = DataObjectPlacement<DTYPE, SPAN>::LockOf(cell);
+            if (cell.constructed) {
+                dataObjPtr->Destroy(instance);
+            }
         }
     }
 
     void ResetRepo(LifeSpan span);
 
+    // groups of Frame slots whose live intervals under order never overlap
+    std::vector<std::vector<SlotIndex>> PlanSharing(const ProcessorOrder& order) const;
+
 private:
     AccessController acl_;
     static constexpr bool ENABLE_ACCESS_CONTROL = true;
+    bool sealed_{false};
+    MemoryPlan plan_;
 
 private:
     DataRepo repos_[enum_id_cast(LifeSpan::Max)];
+    // RCU versions replaced since the last frame boundary
+    RetireList retired_;
 
 private:
     friend struct DataFramework;
     friend struct DataContext;
+    template<typename USER, typename... DTYPEs>
+    friend struct BoundContext;
 };
 
 } // namespace ads_dtf
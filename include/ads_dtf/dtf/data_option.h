@@ -0,0 +1,35 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef DATA_OPTION_H
+#define DATA_OPTION_H
+
+#include <cstdint>
+
+namespace ads_dtf {
+
+enum class DataOption : std::uint32_t {
+    None              = 0,
+    CacheLineIsolated = 1u << 0,
+    EpochReset        = 1u << 1,    // stale once the span resets, a reset never visits it
+    ReuseOnCreate     = 1u << 2,
+    HugePage          = 1u << 3,
+    MemoryLock        = 1u << 4,
+    Lazy              = 1u << 5,
+    SeqLock           = 1u << 6,
+    Rcu               = 1u << 7,
+    Droppable         = 1u << 8,
+};
+
+constexpr DataOption operator|(DataOption lhs, DataOption rhs) {
+    return static_cast<DataOption>(static_cast<std::uint32_t>(lhs) | static_cast<std::uint32_t>(rhs));
+}
+
+constexpr bool has_option(DataOption options, DataOption option) {
+    return (static_cast<std::uint32_t>(options) & static_cast<std::uint32_t>(option)) != 0;
+}
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef DATA_SLOT_H
+#define DATA_SLOT_H
+
+#include "ads_dtf/dtf/life_span.h"
+#include "ads_dtf/utils/enum_cast.h"
+#include <cstddef>
+
+namespace ads_dtf {
+
+using SlotIndex = std::size_t;
+
+constexpr SlotIndex INVALID_SLOT = static_cast<SlotIndex>(-1);
+
+struct DataSlotCounter {
+    static SlotIndex Next(LifeSpan span) {
+        return counters_[enum_id_cast(span)]++;
+    }
+
+    static SlotIndex Count(LifeSpan span) {
+        return counters_[enum_id_cast(span)];
+    }
+
+private:
+    static inline SlotIndex counters_[enum_id_cast(LifeSpan::Max)] = {};
+};
+
+// Selects one of the DtypeInfo::capacity preallocated instances of a data type.
+struct InstanceIndex {
+    explicit constexpr InstanceIndex(std::size_t value) : value(value) {}
+    std::size_t value;
+};
+
+// Dense index of (DTYPE, SPAN), assigned once on the first registration.
+// Constant initialized, so reading it never goes through a guard.
+template<typename DTYPE, LifeSpan SPAN>
+struct DataSlot {
+    static SlotIndex Assign() {
+        if (index == INVALID_SLOT) {
+            index = DataSlotCounter::Next(SPAN);
+        }
+        return index;
+    }
+
+    static inline SlotIndex index = INVALID_SLOT;
+};
+
+struct UserSlotCounter {
+    static SlotIndex Next() {
+        return counter_++;
+    }
+
+private:
+    static inline SlotIndex counter_ = 0;
+};
+
+// Dense index of a user, its row in the access matrix.
+template<typename USER>
+struct UserSlot {
+    static SlotIndex Assign() {
+        if (index == INVALID_SLOT) {
+            index = UserSlotCounter::Next();
+        }
+        return index;
+    }
+
+    static inline SlotIndex index = INVALID_SLOT;
+};
+
+}
+
+#endif
@@ -0,0 +1,112 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef MEMORY_PLAN_H
+#define MEMORY_PLAN_H
+
+#include "ads_dtf/dtf/data_slot.h"
+#include "ads_dtf/dtf/life_span.h"
+#include "ads_dtf/utils/enum_cast.h"
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace ads_dtf {
+
+// Storage footprint of every span as laid out by DataManager::Seal.
+struct MemoryPlan {
+    struct Entry {
+        std::string_view name;
+        SlotIndex slot{INVALID_SLOT};
+        std::size_t size{0};        // sizeof the data type
+        std::size_t align{0};
+        std::size_t capacity{0};
+        std::size_t history{0};
+        std::size_t objectSize{0};  // instances plus their bookkeeping
+        std::size_t objectAlign{0};
+        std::size_t bookkeeping{0}; // locks, flags and epochs of the cells, the ring head
+        std::size_t padding{0};     // alignment gaps, objectSize is instances + bookkeeping + padding
+        std::size_t offset{0};      // from the start of the span arena
+        const char* storage{"arena"};
+    };
+
+    struct Span {
+        std::size_t arenaBytes{0};
+        std::size_t mappedBytes{0};
+        std::size_t fixedBytes{0};
+        std::size_t nodeBytes{0};
+        std::size_t dataBytes{0};
+        std::size_t sharedSavedBytes{0};
+        std::vector<Entry> entries;
+
+        std::size_t TotalBytes() const {
+            return arenaBytes + mappedBytes + fixedBytes + nodeBytes;
+        }
+    };
+
+    Span spans[enum_id_cast(LifeSpan::Max)];
+
+    const Span& Of(LifeSpan span) const {
+        return spans[enum_id_cast(span)];
+    }
+
+    std::size_t TotalBytes() const {
+        std::size_t total = 0;
+        for (auto& span : spans) {
+            total += span.TotalBytes();
+        }
+        return total;
+    }
+
+    void WriteJson(std::ostream& out) const {
+        static const char* SPAN_NAMES[] = {"Frame", "Cache", "Global"};
+
+        out << "{\"total_bytes\":" << TotalBytes() << ",\"spans\":[";
+        for (int i = 0; i < enum_id_cast(LifeSpan::Max); i++) {
+            auto& span = spans[i];
+            out << (i ? "," : "") << "{\"span\":\"" << SPAN_NAMES[i] << "\""
+                << ",\"total_bytes\":" << span.TotalBytes()
+                << ",\"arena_bytes\":" << span.arenaBytes
+                << ",\"mapped_bytes\":" << span.mappedBytes
+                << ",\"fixed_bytes\":" << span.fixedBytes
+                << ",\"node_bytes\":" << span.nodeBytes
+                << ",\"data_bytes\":" << span.dataBytes
+                << ",\"shared_saved_bytes\":" << span.sharedSavedBytes
+                << ",\"types\":[";
+            for (std::size_t j = 0; j < span.entries.size(); j++) {
+                auto& entry = span.entries[j];
+                out << (j ? "," : "") << "{\"name\":\"";
+                WriteEscaped(out, entry.name);
+                out << "\",\"slot\":" << entry.slot
+                    << ",\"size\":" << entry.size
+                    << ",\"align\":" << entry.align
+                    << ",\"capacity\":" << entry.capacity
+                    << ",\"history\":" << entry.history
+                    << ",\"object_size\":" << entry.objectSize
+                    << ",\"object_align\":" << entry.objectAlign
+                    << ",\"bookkeeping\":" << entry.bookkeeping
+                    << ",\"padding\":" << entry.padding
+                    << ",\"offset\":" << entry.offset
+                    << ",\"storage\":\"" << entry.storage << "\"}";
+            }
+            out << "]}";
+        }
+        out << "]}";
+    }
+
+private:
+    static void WriteEscaped(std::ostream& out, std::string_view text) {
+        for (char ch : text) {
+            if (ch == '"' || ch == '\\') {
+                out << '\\';
+            }
+            out << ch;
+        }
+    }
+};
+
+}
+
+#endif
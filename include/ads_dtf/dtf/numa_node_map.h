@@ -0,0 +1,52 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef NUMA_NODE_MAP_H
+#define NUMA_NODE_MAP_H
+
+#include "ads_dtf/dtf/user.h"
+#include "ads_dtf/utils/numa.h"
+#include <utility>
+#include <vector>
+
+namespace ads_dtf {
+
+// Which NUMA node each processor runs on.
+struct NumaNodeMap {
+    template<typename USER>
+    NumaNodeMap& Bind(int node) {
+        return Bind(TypeIdOf<USER>(), node);
+    }
+
+    NumaNodeMap& Bind(UserId user, int node) {
+        for (auto& entry : entries_) {
+            if (entry.first == user) {
+                entry.second = node;
+                return *this;
+            }
+        }
+        entries_.emplace_back(user, node);
+        return *this;
+    }
+
+    int NodeOf(UserId user) const {
+        for (auto& entry : entries_) {
+            if (entry.first == user) {
+                return entry.second;
+            }
+        }
+        return NUMA_NODE_ANY;
+    }
+
+    const std::vector<std::pair<UserId, int>>& Entries() const {
+        return entries_;
+    }
+
+private:
+    std::vector<std::pair<UserId, int>> entries_;
+};
+
+}
+
+#endif
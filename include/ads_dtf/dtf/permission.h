@@ -7,6 +7,10 @@
 
 #include "ads_dtf/dtf/access_mode.h"
 #include "ads_dtf/dtf/life_span.h"
+#include "ads_dtf/dtf/data_option.h"
+#include "ads_dtf/utils/mailbox.h"
+#include "ads_dtf/utils/stream.h"
+#include "ads_dtf/utils/sync_mode.h"
 #include "ads_dtf/utils/void_t.h"
 
 namespace ads_dtf
@@ -32,6 +36,8 @@ template<typename DTYPE, LifeSpan SPAN>
 struct DtypeInfo {
     constexpr static bool sync = false;
     constexpr static std::size_t capacity = 1;
+    constexpr static DataOption options = DataOption::None;
+    constexpr static std::size_t history = 1;
 };
 
 template<AccessMode MODE, LifeSpan SPAN, int COUNT>
@@ -105,7 +111,7 @@ class return_optional_ptr {
     constexpr static AccessMode mode = Permission<USER, DTYPE, SPAN>::mode;
     constexpr static bool sync = Permission<USER, DTYPE, SPAN>::sync;
 public:
-    static constexpr bool value = (!sync && ((mode == AccessMode::Write) || (mode == AccessMode::Create)));
+    static constexpr bool value = (!sync && !is_stream<DTYPE>::value && ((mode == AccessMode::Write) || (mode == AccessMode::Create)));
 };
 
 template <typename USER, typename DTYPE, LifeSpan SPAN>
@@ -113,7 +119,23 @@ class return_const_optional_ptr {
     constexpr static AccessMode mode = Permission<USER, DTYPE, SPAN>::mode;
     constexpr static bool sync = Permission<USER, DTYPE, SPAN>::sync;
 public:
-    static constexpr bool value = (!sync && (mode == AccessMode::Read));
+    static constexpr bool value = (!sync && !is_stream<DTYPE>::value && !is_mailbox<DTYPE>::value && (mode == AccessMode::Read));
+};
+
+template <typename USER, typename DTYPE, LifeSpan SPAN>
+class return_stream_producer {
+    constexpr static AccessMode mode = Permission<USER, DTYPE, SPAN>::mode;
+    constexpr static bool sync = Permission<USER, DTYPE, SPAN>::sync;
+public:
+    static constexpr bool value = (!sync && is_stream<DTYPE>::value && ((mode == AccessMode::Write) || (mode == AccessMode::Create)));
+};
+
+template <typename USER, typename DTYPE, LifeSpan SPAN>
+class return_channel_consumer {
+    constexpr static AccessMode mode = Permission<USER, DTYPE, SPAN>::mode;
+    constexpr static bool sync = Permission<USER, DTYPE, SPAN>::sync;
+public:
+    static constexpr bool value = (!sync && (is_stream<DTYPE>::value || is_mailbox<DTYPE>::value) && (mode == AccessMode::Read));
 };
 
 template <typename USER, typename DTYPE, LifeSpan SPAN>
@@ -132,6 +154,15 @@ public:
     static constexpr bool value = (sync && (mode == AccessMode::Read));
 };
 
+// how the sync overloads guard the data: a reader-writer lock, a seqlock for
+// data registered with DataOption::SeqLock, or RCU for DataOption::Rcu
+template <typename DTYPE, LifeSpan SPAN>
+struct sync_mode_of {
+    static constexpr SyncMode value = !DtypeInfo<DTYPE, SPAN>::sync ? SyncMode::None :
+        has_option(DtypeInfo<DTYPE, SPAN>::options, DataOption::SeqLock) ? SyncMode::SeqLock :
+        has_option(DtypeInfo<DTYPE, SPAN>::options, DataOption::Rcu) ? SyncMode::Rcu : SyncMode::Sync;
+};
+
 } // namespace ads_dtf
 
 #endif
@@ -20,35 +20,41 @@ struct PermissionRegister {
 };
 
 //////////////////////////////////////////////////////////////////////////////////////// 
-#define PERMISSION_REGISTER_FOR_CREATE(USER, SPAN, DTYPE, CAPACITY) \
+#define PERMISSION_REGISTER_FOR_CREATE_IMPL(USER, SPAN, DTYPE, CAPACITY, SYNC, OPTIONS, HISTORY) \
     template<>                                                      \
-    struct Permission<USER, DTYPE, LifeSpan::SPAN> {                \
+    struct ads_dtf::Permission<USER, DTYPE, ads_dtf::LifeSpan::SPAN> { \
         constexpr static AccessMode mode = AccessMode::Create;      \
-        constexpr static bool sync = false;                         \
+        constexpr static bool sync = SYNC;                          \
     };                                                              \
     template<>                                                      \
-    struct DtypeInfo<DTYPE, LifeSpan::SPAN> {                       \
-        constexpr static bool sync = false;                         \
+    struct ads_dtf::DtypeInfo<DTYPE, ads_dtf::LifeSpan::SPAN> {     \
+        constexpr static bool sync = SYNC;                          \
         constexpr static std::size_t capacity = CAPACITY;           \
-    };                                                              \
+        constexpr static DataOption options = OPTIONS;              \
+        constexpr static std::size_t history = HISTORY;             \
+    }
+
+#define PERMISSION_REGISTER_FOR_CREATE(USER, SPAN, DTYPE, CAPACITY) \
+    PERMISSION_REGISTER_FOR_CREATE_OPT(USER, SPAN, DTYPE, CAPACITY, DataOption::None)
+
+#define PERMISSION_REGISTER_FOR_CREATE_OPT(USER, SPAN, DTYPE, CAPACITY, OPTIONS) \
+    PERMISSION_REGISTER_FOR_CREATE_IMPL(USER, SPAN, DTYPE, CAPACITY, false, OPTIONS, 1); \
     static PermissionRegister<USER, DTYPE, LifeSpan::SPAN, AccessMode::Create> UNIQUE_NAME(reg_Create)
 
+#define PERMISSION_REGISTER_FOR_CREATE_HISTORY(USER, SPAN, DTYPE, CAPACITY, HISTORY) \
+    PERMISSION_REGISTER_FOR_CREATE_IMPL(USER, SPAN, DTYPE, CAPACITY, false, DataOption::None, HISTORY); \
+    static PermissionRegister<USER, DTYPE, LifeSpan::SPAN, AccessMode::Create> UNIQUE_NAME(reg_Create_History)
+
 #define PERMISSION_REGISTER_FOR_CREATE_SYNC(USER, SPAN, DTYPE, CAPACITY) \
-    template<>                                                      \
-    struct Permission<USER, DTYPE, LifeSpan::SPAN> {                \
-        constexpr static AccessMode mode = AccessMode::Create;      \
-        constexpr static bool sync = true;                          \
-    };                                                              \
-    template<>                                                      \
-    struct DtypeInfo<DTYPE, LifeSpan::SPAN> {                       \
-        constexpr static bool sync = true;                          \
-        constexpr static std::size_t capacity = CAPACITY;           \
-    };                                                              \
+    PERMISSION_REGISTER_FOR_CREATE_SYNC_OPT(USER, SPAN, DTYPE, CAPACITY, DataOption::None)
+
+#define PERMISSION_REGISTER_FOR_CREATE_SYNC_OPT(USER, SPAN, DTYPE, CAPACITY, OPTIONS) \
+    PERMISSION_REGISTER_FOR_CREATE_IMPL(USER, SPAN, DTYPE, CAPACITY, true, OPTIONS, 1); \
     static PermissionRegister<USER, DTYPE, LifeSpan::SPAN, AccessMode::Create> UNIQUE_NAME(reg_Create_Sync)
 
 #define PERMISSION_REGISTER_FOR_READ(USER, SPAN, DTYPE)             \
     template<>                                                      \
-    struct Permission<USER, DTYPE, LifeSpan::SPAN> {                \
+    struct ads_dtf::Permission<USER, DTYPE, ads_dtf::LifeSpan::SPAN> { \
         constexpr static AccessMode mode = AccessMode::Read;        \
         constexpr static bool sync = false;                         \
     };                                                              \
@@ -56,7 +62,7 @@ struct PermissionRegister {
 
 #define PERMISSION_REGISTER_FOR_READ_SYNC(USER, SPAN, DTYPE)        \
     template<>                                                      \
-    struct Permission<USER, DTYPE, LifeSpan::SPAN> {                \
+    struct ads_dtf::Permission<USER, DTYPE, ads_dtf::LifeSpan::SPAN> { \
         constexpr static AccessMode mode = AccessMode::Read;        \
         constexpr static bool sync = true;                          \
     };                                                              \
@@ -64,7 +70,7 @@ struct PermissionRegister {
 
 #define PERMISSION_REGISTER_FOR_WRITE(USER, SPAN, DTYPE)            \
     template<>                                                      \
-    struct Permission<USER, DTYPE, LifeSpan::SPAN> {                \
+    struct ads_dtf::Permission<USER, DTYPE, ads_dtf::LifeSpan::SPAN> { \
         constexpr static AccessMode mode = AccessMode::Write;       \
         constexpr static bool sync = false;                         \
     };                                                              \
@@ -72,7 +78,7 @@ struct PermissionRegister {
 
 #define PERMISSION_REGISTER_FOR_WRITE_SYNC(USER, SPAN, DTYPE)       \
     template<>                                                      \
-    struct Permission<USER, DTYPE, LifeSpan::SPAN> {                \
+    struct ads_dtf::Permission<USER, DTYPE, ads_dtf::LifeSpan::SPAN> { \
         constexpr static AccessMode mode = AccessMode::Write;       \
         constexpr static bool sync = true;                          \
     };                                                              \
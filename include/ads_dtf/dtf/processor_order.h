@@ -0,0 +1,37 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef PROCESSOR_ORDER_H
+#define PROCESSOR_ORDER_H
+
+#include "ads_dtf/dtf/user.h"
+#include <cstddef>
+#include <vector>
+
+namespace ads_dtf {
+
+// The order processors run in within a frame, e.g.
+// ProcessorOrder().Then<Driver>().Then<Detector>().Then<Planner>()
+struct ProcessorOrder {
+    template<typename USER>
+    ProcessorOrder& Then() {
+        users_.push_back(TypeIdOf<USER>());
+        return *this;
+    }
+
+    const std::vector<UserId>& Users() const {
+        return users_;
+    }
+
+    bool Empty() const {
+        return users_.empty();
+    }
+
+private:
+    std::vector<UserId> users_;
+};
+
+}
+
+#endif
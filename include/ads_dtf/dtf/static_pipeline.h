@@ -0,0 +1,218 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef STATIC_PIPELINE_H
+#define STATIC_PIPELINE_H
+
+#include "ads_dtf/dtf/permission.h"
+#include "ads_dtf/utils/mailbox.h"
+#include "ads_dtf/utils/placement.h"
+#include "ads_dtf/utils/stream.h"
+#include "ads_dtf/utils/auto_construct.h"
+#include "ads_dtf/utils/auto_clear.h"
+#include "ads_dtf/utils/optional_ptr.h"
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ads_dtf {
+
+template<typename... USERs>
+struct ProcessorList {};
+
+template<typename... DTYPEs>
+struct DataList {};
+
+// Alternative front end to DataManager for pipelines whose processors and data
+// are all known at compile time. Each span is one std::tuple member, so a Fetch
+// is a constant offset from the pipeline with no slot or repo lookup. It uses
+// the same Permission and DtypeInfo declarations as the registration macros,
+// or those of the STATIC_PERMISSION_FOR_* macros below for data that only a
+// static pipeline uses and the DataFramework singleton never sees.
+//
+// using Pipeline = StaticPipeline<ProcessorList<Driver, Planner>,
+//                                 DataList<FrameData>,       // Frame
+//                                 DataList<>,                // Cache
+//                                 DataList<MapData>>;        // Global
+template<typename PROCESSORS, typename FRAME, typename CACHE = DataList<>, typename GLOBAL = DataList<>>
+struct StaticPipeline;
+
+template<typename... USERs, typename... FRAMEs, typename... CACHEs, typename... GLOBALs>
+struct StaticPipeline<ProcessorList<USERs...>, DataList<FRAMEs...>, DataList<CACHEs...>, DataList<GLOBALs...>> {
+    StaticPipeline() {
+        ForEachCell([](auto& cell) {
+            cell.constructed = auto_construct(cell.placement.GetPointer());
+        });
+    }
+
+    ~StaticPipeline() {
+        ForEachCell([](auto& cell) {
+            if (cell.constructed) {
+                cell.placement.Destroy();
+            }
+        });
+    }
+
+    StaticPipeline(const StaticPipeline&) = delete;
+    StaticPipeline& operator=(const StaticPipeline&) = delete;
+
+    template<typename DTYPE, LifeSpan SPAN = LifeSpan::Max, typename USER>
+    auto Fetch(const USER*) {
+        constexpr LifeSpan span = CheckedSpan<USER, DTYPE, SPAN>();
+        constexpr AccessMode mode = Permission<USER, DTYPE, span>::mode;
+
+        auto& cell = CellOf<DTYPE, span>();
+        DTYPE* dataPtr = cell.constructed ? cell.placement.GetPointer() : nullptr;
+        if constexpr (mode == AccessMode::Read) {
+            return OptionalPtr<const DTYPE, SyncMode::None>(dataPtr);
+        } else {
+            return OptionalPtr<DTYPE, SyncMode::None>(dataPtr);
+        }
+    }
+
+    template<typename DTYPE, LifeSpan SPAN = LifeSpan::Max, typename USER, typename... ARGs>
+    auto Create(const USER*, ARGs&&... args) {
+        constexpr LifeSpan span = CheckedSpan<USER, DTYPE, SPAN>();
+        static_assert(Permission<USER, DTYPE, span>::mode == AccessMode::Create, "Invalid AccessMode");
+
+        auto& cell = CellOf<DTYPE, span>();
+        if (cell.constructed) {
+            cell.placement.Destroy();
+        }
+        auto dataPtr = new (cell.placement.Alloc()) DTYPE(std::forward<ARGs>(args)...);
+        cell.constructed = true;
+        return OptionalPtr<DTYPE, SyncMode::None>(dataPtr);
+    }
+
+    template<typename DTYPE, LifeSpan SPAN = LifeSpan::Max, typename USER>
+    void Destroy(const USER*) {
+        constexpr LifeSpan span = CheckedSpan<USER, DTYPE, SPAN>();
+        static_assert(Permission<USER, DTYPE, span>::mode == AccessMode::Create, "Invalid AccessMode");
+
+        auto& cell = CellOf<DTYPE, span>();
+        if (cell.constructed) {
+            cell.placement.Destroy();
+            cell.constructed = false;
+        }
+    }
+
+    void ResetRepo(LifeSpan span) {
+        auto clear = [](auto& cell) {
+            if (cell.constructed) {
+                auto_clear(cell.placement.GetPointer());
+            }
+        };
+        switch (span) {
+        case LifeSpan::Frame: ForEachCellOf(frame_, clear); break;
+        case LifeSpan::Cache: ForEachCellOf(cache_, clear); break;
+        case LifeSpan::Global: ForEachCellOf(global_, clear); break;
+        default: break;
+        }
+    }
+
+private:
+    template<typename DTYPE>
+    struct Cell {
+        Placement<DTYPE> placement;
+        bool constructed{false};
+    };
+
+    template<typename DTYPE, LifeSpan SPAN>
+    static constexpr bool HasCreator() {
+        return (... || (Permission<USERs, DTYPE, SPAN>::mode == AccessMode::Create));
+    }
+
+    static_assert((HasCreator<FRAMEs, LifeSpan::Frame>() && ...), "Frame data without a creator in the pipeline");
+    static_assert((HasCreator<CACHEs, LifeSpan::Cache>() && ...), "Cache data without a creator in the pipeline");
+    static_assert((HasCreator<GLOBALs, LifeSpan::Global>() && ...), "Global data without a creator in the pipeline");
+
+    template<typename DTYPE, LifeSpan SPAN>
+    static constexpr bool IsDeclared() {
+        if constexpr (SPAN == LifeSpan::Frame) {
+            return (... || std::is_same<DTYPE, FRAMEs>::value);
+        } else if constexpr (SPAN == LifeSpan::Cache) {
+            return (... || std::is_same<DTYPE, CACHEs>::value);
+        } else {
+            return (... || std::is_same<DTYPE, GLOBALs>::value);
+        }
+    }
+
+    template<typename USER, typename DTYPE, LifeSpan SPAN>
+    static constexpr LifeSpan CheckedSpan() {
+        constexpr LifeSpan span = PermissionQuery<USER, DTYPE, SPAN>::span;
+        static_assert(span != LifeSpan::Max, "Invalid access to data of lifespan!");
+        static_assert((... || std::is_same<USER, USERs>::value), "Processor is not part of the pipeline");
+        static_assert(IsDeclared<DTYPE, span>(), "Data is not part of the pipeline");
+        static_assert(DtypeInfo<DTYPE, span>::capacity == 1, "Invalid capacity");
+        static_assert(DtypeInfo<DTYPE, span>::history == 1, "Invalid history depth");
+        static_assert(!DtypeInfo<DTYPE, span>::sync, "Invalid Sync");
+        static_assert(DtypeInfo<DTYPE, span>::options == DataOption::None, "Invalid DataOption, a static pipeline supports none");
+        static_assert(!is_mailbox<DTYPE>::value && !is_stream<DTYPE>::value, "A mailbox or stream needs the DataManager");
+        return span;
+    }
+
+    template<typename DTYPE, LifeSpan SPAN>
+    Cell<DTYPE>& CellOf() {
+        if constexpr (SPAN == LifeSpan::Frame) {
+            return std::get<Cell<DTYPE>>(frame_);
+        } else if constexpr (SPAN == LifeSpan::Cache) {
+            return std::get<Cell<DTYPE>>(cache_);
+        } else {
+            return std::get<Cell<DTYPE>>(global_);
+        }
+    }
+
+    template<typename STORAGE, typename VISITOR>
+    static void ForEachCellOf(STORAGE& storage, VISITOR&& visit) {
+        std::apply([&visit](auto&... cells) { (visit(cells), ...); }, storage);
+    }
+
+    template<typename VISITOR>
+    void ForEachCell(VISITOR&& visit) {
+        ForEachCellOf(frame_, visit);
+        ForEachCellOf(cache_, visit);
+        ForEachCellOf(global_, visit);
+    }
+
+private:
+    std::tuple<Cell<FRAMEs>...> frame_;
+    std::tuple<Cell<CACHEs>...> cache_;
+    std::tuple<Cell<GLOBALs>...> global_;
+};
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Declare the permissions of data only a StaticPipeline uses: the same
+// Permission and DtypeInfo as the registration macros, with nothing registered
+// at run time. Its capacity and history are one, it has no options.
+#define STATIC_PERMISSION_FOR_CREATE(USER, SPAN, DTYPE)             \
+    template<>                                                      \
+    struct ads_dtf::Permission<USER, DTYPE, ads_dtf::LifeSpan::SPAN> { \
+        constexpr static ads_dtf::AccessMode mode = ads_dtf::AccessMode::Create; \
+        constexpr static bool sync = false;                         \
+    };                                                              \
+    template<>                                                      \
+    struct ads_dtf::DtypeInfo<DTYPE, ads_dtf::LifeSpan::SPAN> {     \
+        constexpr static bool sync = false;                         \
+        constexpr static std::size_t capacity = 1;                  \
+        constexpr static ads_dtf::DataOption options = ads_dtf::DataOption::None; \
+        constexpr static std::size_t history = 1;                   \
+    }
+
+#define STATIC_PERMISSION_FOR_READ(USER, SPAN, DTYPE)               \
+    template<>                                                      \
+    struct ads_dtf::Permission<USER, DTYPE, ads_dtf::LifeSpan::SPAN> { \
+        constexpr static ads_dtf::AccessMode mode = ads_dtf::AccessMode::Read; \
+        constexpr static bool sync = false;                         \
+    }
+
+#define STATIC_PERMISSION_FOR_WRITE(USER, SPAN, DTYPE)              \
+    template<>                                                      \
+    struct ads_dtf::Permission<USER, DTYPE, ads_dtf::LifeSpan::SPAN> { \
+        constexpr static ads_dtf::AccessMode mode = ads_dtf::AccessMode::Write; \
+        constexpr static bool sync = false;                         \
+    }
+
+#endif
@@ -0,0 +1,93 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace ads_dtf {
+
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+constexpr std::size_t align_up(std::size_t value, std::size_t align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+// One contiguous, aligned block of raw memory. It never constructs or
+// moves objects itself, the owner relocates them when it reallocates.
+struct Arena {
+    Arena() = default;
+
+    Arena(std::size_t capacity, std::size_t alignment)
+    : alignment_(alignment), capacity_(capacity) {
+        if (capacity_ > 0) {
+            data_ = static_cast<char*>(::operator new(capacity_, std::align_val_t(alignment_), std::nothrow));
+            if (!data_) {
+                capacity_ = 0;
+            }
+        }
+    }
+
+    ~Arena() {
+        Release();
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    Arena(Arena&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    Arena& operator=(Arena&& other) noexcept {
+        if (this != &other) {
+            Release();
+            data_ = std::exchange(other.data_, nullptr);
+            alignment_ = std::exchange(other.alignment_, CACHE_LINE_SIZE);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+
+    char* Data() const {
+        return data_;
+    }
+
+    std::size_t Capacity() const {
+        return capacity_;
+    }
+
+    std::size_t Alignment() const {
+        return alignment_;
+    }
+
+    bool Fits(std::size_t end, std::size_t align) const {
+        return (end <= capacity_) && (align <= alignment_);
+    }
+
+    bool Contains(const void* ptr) const {
+        auto p = static_cast<const char*>(ptr);
+        return (p >= data_) && (p < data_ + capacity_);
+    }
+
+private:
+    void Release() {
+        if (data_) {
+            ::operator delete(data_, std::align_val_t(alignment_));
+            data_ = nullptr;
+        }
+    }
+
+private:
+    char* data_{nullptr};
+    std::size_t alignment_{CACHE_LINE_SIZE};
+    std::size_t capacity_{0};
+};
+
+}
+
+#endif
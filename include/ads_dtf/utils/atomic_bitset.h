@@ -0,0 +1,72 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef ATOMIC_BITSET_H
+#define ATOMIC_BITSET_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ads_dtf {
+
+// Bitset whose bits may be set and cleared from several threads at once,
+// the words are read and cleared whole by a single thread. Resize is not
+// thread safe, it belongs to registration.
+struct AtomicBitset {
+    using Word = std::uint64_t;
+    static constexpr std::size_t WORD_BITS = 64;
+
+    void Resize(std::size_t bits) {
+        std::size_t count = (bits + WORD_BITS - 1) / WORD_BITS;
+        if (count != words_.size()) {
+            std::vector<std::atomic<Word>> words(count);
+            for (std::size_t i = 0; i < std::min(count, words_.size()); i++) {
+                words[i].store(words_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+            words_.swap(words);
+        }
+        bits_ = bits;
+    }
+
+    std::size_t Size() const {
+        return bits_;
+    }
+
+    // a bit already set costs a load and no write, its line stays shared
+    void Set(std::size_t bit) {
+        auto& word = words_[bit / WORD_BITS];
+        Word mask = Word(1) << (bit % WORD_BITS);
+        if (!(word.load(std::memory_order_relaxed) & mask)) {
+            word.fetch_or(mask, std::memory_order_relaxed);
+        }
+    }
+
+    void Reset(std::size_t bit) {
+        words_[bit / WORD_BITS].fetch_and(~(Word(1) << (bit % WORD_BITS)), std::memory_order_relaxed);
+    }
+
+    bool Test(std::size_t bit) const {
+        return (words_[bit / WORD_BITS].load(std::memory_order_relaxed) >> (bit % WORD_BITS)) & 1;
+    }
+
+    std::size_t WordCount() const {
+        return words_.size();
+    }
+
+    // clears a word and returns the bits it held
+    Word TakeWord(std::size_t index) {
+        return words_[index].exchange(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::vector<std::atomic<Word>> words_;
+    std::size_t bits_{0};
+};
+
+}
+
+#endif
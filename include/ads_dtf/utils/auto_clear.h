@@ -5,11 +5,11 @@
 #ifndef AUTO_CLEAR_H
 #define AUTO_CLEAR_H
 
-namespace ads_dtf {
-
 #include <type_traits>
 #include <utility>
 
+namespace ads_dtf {
+
 // Trait to detect member function void clear()
 template <typename T>
 class has_member_clear {
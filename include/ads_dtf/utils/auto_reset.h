@@ -0,0 +1,63 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef AUTO_RESET_H
+#define AUTO_RESET_H
+
+#include "ads_dtf/utils/auto_clear.h"
+#include <type_traits>
+#include <utility>
+
+namespace ads_dtf {
+
+// Trait to detect member function reset(ARGs...)
+template <typename T, typename... ARGs>
+class has_member_reset {
+private:
+    template <typename U>
+    static auto test(int) -> decltype(std::declval<U&>().reset(std::declval<ARGs>()...), std::true_type());
+
+    template <typename U>
+    static std::false_type test(...);
+
+public:
+    static constexpr bool value = decltype(test<T>(0))::value;
+};
+
+// Trait to check if a live object is refilled by its clear method
+template <typename T, typename... ARGs>
+struct reset_by_clear {
+    static constexpr bool value = !has_member_reset<T, ARGs...>::value && 
+                                  sizeof...(ARGs) == 0 && has_any_clear<T>::value;
+};
+
+// Overload for member reset(args...), the live object refills itself
+template <typename T, typename... ARGs>
+typename std::enable_if<has_member_reset<T, ARGs...>::value, void>::type
+auto_reset_impl(T* ptr, ARGs&&... args) {
+    ptr->reset(std::forward<ARGs>(args)...);
+}
+
+// Overload for clear() without arguments, it keeps the capacity of the live object
+template <typename T, typename... ARGs>
+typename std::enable_if<reset_by_clear<T, ARGs...>::value, void>::type
+auto_reset_impl(T* ptr, ARGs&&...) {
+    auto_clear(ptr);
+}
+
+// Overload for others, assign a new value into the live object
+template <typename T, typename... ARGs>
+typename std::enable_if<!has_member_reset<T, ARGs...>::value && !reset_by_clear<T, ARGs...>::value, void>::type
+auto_reset_impl(T* ptr, ARGs&&... args) {
+    *ptr = T(std::forward<ARGs>(args)...);
+}
+
+template <typename T, typename... ARGs>
+void auto_reset(T* ptr, ARGs&&... args) {
+    auto_reset_impl(ptr, std::forward<ARGs>(args)...);
+}
+
+}
+
+#endif
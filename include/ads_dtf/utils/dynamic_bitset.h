@@ -0,0 +1,87 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef DYNAMIC_BITSET_H
+#define DYNAMIC_BITSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ads_dtf {
+
+struct DynamicBitset {
+    using Word = std::uint64_t;
+    static constexpr std::size_t WORD_BITS = 64;
+
+    void Resize(std::size_t bits) {
+        bits_ = bits;
+        words_.resize((bits + WORD_BITS - 1) / WORD_BITS, 0);
+    }
+
+    std::size_t Size() const {
+        return bits_;
+    }
+
+    void Set(std::size_t bit) {
+        words_[bit / WORD_BITS] |= (Word(1) << (bit % WORD_BITS));
+    }
+
+    void Reset(std::size_t bit) {
+        words_[bit / WORD_BITS] &= ~(Word(1) << (bit % WORD_BITS));
+    }
+
+    bool Test(std::size_t bit) const {
+        return (words_[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+    }
+
+    void ResetAll() {
+        for (auto& word : words_) {
+            word = 0;
+        }
+    }
+
+    std::size_t Count() const {
+        std::size_t count = 0;
+        for (auto word : words_) {
+            count += __builtin_popcountll(word);
+        }
+        return count;
+    }
+
+    std::size_t WordCount() const {
+        return words_.size();
+    }
+
+    Word GetWord(std::size_t index) const {
+        return words_[index];
+    }
+
+    void SetWord(std::size_t index, Word word) {
+        words_[index] = word;
+    }
+
+    template<typename VISITOR>
+    static void ForEachBit(Word word, std::size_t base, VISITOR&& visit) {
+        while (word) {
+            visit(base + __builtin_ctzll(word));
+            word &= (word - 1);
+        }
+    }
+
+    template<typename VISITOR>
+    void ForEach(VISITOR&& visit) const {
+        for (std::size_t i = 0; i < words_.size(); i++) {
+            ForEachBit(words_[i], i * WORD_BITS, visit);
+        }
+    }
+
+private:
+    std::vector<Word> words_;
+    std::size_t bits_{0};
+};
+
+}
+
+#endif
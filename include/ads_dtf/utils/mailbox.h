@@ -0,0 +1,114 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include "ads_dtf/utils/arena.h"
+#include "ads_dtf/utils/optional_ptr.h"
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace ads_dtf {
+
+// Hands the latest value from one writer thread to one reader thread through
+// three buffers, neither side ever waits. The writer fills its back buffer and
+// swaps it with the middle one, the reader swaps the middle one in as its front
+// buffer when it holds a newer value. Values the reader never took are dropped.
+//
+template<typename MAILBOX>
+struct MailboxConsumer;
+
+// Registered as Cache or Global data, a driver thread fetches it as a writer
+// and posts, the frame producer takes the newest value at frame start. Its
+// creator and writers fetch the mailbox itself, a reader gets a Consumer.
+template<typename T>
+struct Mailbox {
+    static_assert(std::is_default_constructible<T>::value, "Mailbox values must be default constructible");
+
+    using value_type = T;
+    using Consumer = MailboxConsumer<Mailbox>;
+
+    // fill gets the back buffer in place, it still holds an older value
+    template<typename FILL>
+    void Write(FILL&& fill) {
+        fill(buffers_[back_].value);
+        back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    void Post(const T& value) {
+        Write([&value](T& back) { back = value; });
+    }
+
+    void Post(T&& value) {
+        Write([&value](T& back) { back = std::move(value); });
+    }
+
+    // The newest value if one was posted since the last Take, without a copy.
+    // It belongs to the reader and stays valid until its next Take.
+    OptionalPtr<T> Take() {
+        if (!HasNews()) {
+            return OptionalPtr<T>(nullptr);
+        }
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+        return OptionalPtr<T>(&buffers_[front_].value);
+    }
+
+    bool HasNews() const {
+        return (middle_.load(std::memory_order_relaxed) & FRESH) != 0;
+    }
+
+private:
+    static constexpr std::uint8_t INDEX = 3;
+    static constexpr std::uint8_t FRESH = 4;
+
+    struct alignas(CACHE_LINE_SIZE) Buffer {
+        T value;
+    };
+
+private:
+    Buffer buffers_[3];
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint8_t> middle_{1};
+    // owned by the writer and the reader thread, kept on lines of their own
+    alignas(CACHE_LINE_SIZE) std::uint8_t back_{0};
+    alignas(CACHE_LINE_SIZE) std::uint8_t front_{2};
+};
+
+// The taking end of a mailbox for its reader, empty when the mailbox could
+// not be fetched.
+template<typename MAILBOX>
+struct MailboxConsumer {
+    using T = typename MAILBOX::value_type;
+
+    explicit MailboxConsumer(MAILBOX* mailbox) : mailbox_(mailbox) {}
+
+    bool HasValue() const { return mailbox_ != nullptr; }
+    explicit operator bool() const { return HasValue(); }
+
+    OptionalPtr<const T> Take() {
+        assert(mailbox_ && "MailboxConsumer is null. Assertion failed.");
+        return OptionalPtr<const T>(mailbox_->Take().Get());
+    }
+
+    bool HasNews() const {
+        assert(mailbox_ && "MailboxConsumer is null. Assertion failed.");
+        return mailbox_->HasNews();
+    }
+
+private:
+    MAILBOX* mailbox_;
+};
+
+template<typename T>
+struct is_mailbox : std::false_type {};
+
+template<typename T>
+struct is_mailbox<Mailbox<T>> : std::true_type {};
+
+}
+
+#endif
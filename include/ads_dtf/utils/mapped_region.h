@@ -0,0 +1,160 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef MAPPED_REGION_H
+#define MAPPED_REGION_H
+
+#include "ads_dtf/utils/arena.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ads_dtf {
+
+constexpr std::size_t HUGE_PAGE_SIZE = std::size_t(2) << 20;
+
+// Anonymous mapping for large data: aligned and advised for transparent huge
+// pages, prefaulted up front and optionally locked in memory. Falls back to
+// an ordinary aligned allocation where mmap is not available.
+struct MappedRegion {
+    MappedRegion() = default;
+
+    MappedRegion(std::size_t size, bool lock) {
+        size_ = align_up(size, HUGE_PAGE_SIZE);
+#ifdef __linux__
+        // over map by one huge page so the region can start on a huge page boundary
+        std::size_t mapped = size_ + HUGE_PAGE_SIZE;
+        void* addr = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) {
+            size_ = 0;
+            return;
+        }
+
+        auto begin = reinterpret_cast<std::uintptr_t>(addr);
+        auto aligned = align_up(begin, HUGE_PAGE_SIZE);
+        if (aligned > begin) {
+            ::munmap(addr, aligned - begin);
+        }
+        std::size_t tail = (begin + mapped) - (aligned + size_);
+        if (tail > 0) {
+            ::munmap(reinterpret_cast<void*>(aligned + size_), tail);
+        }
+        data_ = reinterpret_cast<char*>(aligned);
+
+#ifdef MADV_HUGEPAGE
+        ::madvise(data_, size_, MADV_HUGEPAGE);
+#endif
+        Prefault();
+        locked_ = lock && (::mlock(data_, size_) == 0);
+#else
+        data_ = static_cast<char*>(::operator new(size_, std::align_val_t(HUGE_PAGE_SIZE), std::nothrow));
+        if (!data_) {
+            size_ = 0;
+            return;
+        }
+        Prefault();
+#endif
+    }
+
+    ~MappedRegion() {
+        Release();
+    }
+
+    MappedRegion(const MappedRegion&) = delete;
+    MappedRegion& operator=(const MappedRegion&) = delete;
+
+    MappedRegion(MappedRegion&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedRegion& operator=(MappedRegion&& other) noexcept {
+        if (this != &other) {
+            Release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            locked_ = std::exchange(other.locked_, false);
+        }
+        return *this;
+    }
+
+    char* Data() const {
+        return data_;
+    }
+
+    std::size_t Size() const {
+        return size_;
+    }
+
+    bool Locked() const {
+        return locked_;
+    }
+
+    // bytes of the region the kernel currently backs with huge pages
+    std::size_t HugePageBytes() const {
+        std::size_t hugeBytes = 0;
+#ifdef __linux__
+        if (!data_) return 0;
+
+        FILE* smaps = std::fopen("/proc/self/smaps", "r");
+        if (!smaps) return 0;
+
+        auto addr = reinterpret_cast<std::uintptr_t>(data_);
+        bool inRegion = false;
+        char line[256];
+        while (std::fgets(line, sizeof(line), smaps)) {
+            unsigned long long start = 0, end = 0;
+            if (std::sscanf(line, "%llx-%llx ", &start, &end) == 2) {
+                inRegion = (start <= addr) && (addr < end);
+                continue;
+            }
+            unsigned long long kb = 0;
+            if (inRegion && std::sscanf(line, "AnonHugePages: %llu kB", &kb) == 1) {
+                hugeBytes = std::min<std::size_t>(kb * 1024, size_);
+                break;
+            }
+        }
+        std::fclose(smaps);
+#endif
+        return hugeBytes;
+    }
+
+private:
+    void Prefault() {
+        constexpr std::size_t SMALL_PAGE_SIZE = 4096;
+        for (std::size_t offset = 0; offset < size_; offset += SMALL_PAGE_SIZE) {
+            reinterpret_cast<volatile char*>(data_)[offset] = 0;
+        }
+    }
+
+    void Release() {
+        if (!data_) return;
+#ifdef __linux__
+        if (locked_) {
+            ::munlock(data_, size_);
+        }
+        ::munmap(data_, size_);
+#else
+        ::operator delete(data_, std::align_val_t(HUGE_PAGE_SIZE));
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        locked_ = false;
+    }
+
+private:
+    char* data_{nullptr};
+    std::size_t size_{0};
+    bool locked_{false};
+};
+
+}
+
+#endif
@@ -0,0 +1,161 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ads_dtf {
+
+constexpr int NUMA_NODE_ANY = -1;
+constexpr std::size_t NUMA_PAGE_SIZE = 4096;
+
+namespace numa_detail {
+    // parse a sysfs cpu or node list such as "0-3,8,10-11"
+    inline std::vector<int> ReadList(const char* path) {
+        std::vector<int> ids;
+        FILE* file = std::fopen(path, "r");
+        if (!file) return ids;
+
+        int first = 0;
+        while (std::fscanf(file, "%d", &first) == 1) {
+            int last = first;
+            int ch = std::fgetc(file);
+            if (ch == '-') {
+                if (std::fscanf(file, "%d", &last) != 1) break;
+                ch = std::fgetc(file);
+            }
+            for (int id = first; id <= last; id++) {
+                ids.push_back(id);
+            }
+            if (ch != ',') break;
+        }
+        std::fclose(file);
+        return ids;
+    }
+}
+
+inline int numa_node_count() {
+    auto nodes = numa_detail::ReadList("/sys/devices/system/node/online");
+    return nodes.empty() ? 1 : nodes.back() + 1;
+}
+
+// Binds the pages of [addr, addr + size) to node and migrates pages already
+// touched. The range must be page aligned. Returns false where unsupported.
+inline bool numa_bind(void* addr, std::size_t size, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+    if (node < 0 || node >= 64 || size == 0) return false;
+
+    constexpr int MODE_BIND = 2;          // MPOL_BIND
+    constexpr unsigned FLAG_MOVE = 1u << 1; // MPOL_MF_MOVE
+    unsigned long mask = 1ul << node;
+    return ::syscall(SYS_mbind, addr, size, MODE_BIND, &mask, sizeof(mask) * 8, FLAG_MOVE) == 0;
+#else
+    return false;
+#endif
+}
+
+// Page aligned anonymous mapping bound to one node before its pages are first
+// touched. The policy goes away with the mapping, where heap pages would go
+// back to the allocator still bound. Empty where mmap or mbind is unsupported.
+struct NodeRegion {
+    NodeRegion() = default;
+
+    NodeRegion(std::size_t size, int node) {
+#ifdef __linux__
+        std::size_t mapped = (size + NUMA_PAGE_SIZE - 1) / NUMA_PAGE_SIZE * NUMA_PAGE_SIZE;
+        void* addr = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) {
+            return;
+        }
+        if (!numa_bind(addr, mapped, node)) {
+            ::munmap(addr, mapped);
+            return;
+        }
+        data_ = static_cast<char*>(addr);
+        size_ = mapped;
+#else
+        (void)size;
+        (void)node;
+#endif
+    }
+
+    ~NodeRegion() {
+        Release();
+    }
+
+    NodeRegion(const NodeRegion&) = delete;
+    NodeRegion& operator=(const NodeRegion&) = delete;
+
+    NodeRegion(NodeRegion&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    NodeRegion& operator=(NodeRegion&& other) noexcept {
+        if (this != &other) {
+            Release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    char* Data() const {
+        return data_;
+    }
+
+    std::size_t Size() const {
+        return size_;
+    }
+
+private:
+    void Release() {
+#ifdef __linux__
+        if (data_) {
+            ::munmap(data_, size_);
+        }
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+private:
+    char* data_{nullptr};
+    std::size_t size_{0};
+};
+
+// Pins the calling thread to the cpus of node, used by benchmarks and drivers.
+inline bool numa_run_on_node(int node) {
+#ifdef __linux__
+    char path[64];
+    std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    auto cpus = numa_detail::ReadList(path);
+    if (cpus.empty()) return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+}
+
+#endif
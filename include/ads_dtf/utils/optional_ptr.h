@@ -6,7 +6,15 @@
 #define OPTIONAL_PTR_H
 
 #include "ads_dtf/utils/sync_mode.h"
+#include "ads_dtf/utils/seq_lock.h"
+#include "ads_dtf/utils/retire_list.h"
+#include <atomic>
 #include <shared_mutex>
+#include <mutex>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
 #include <utility>
 
 namespace ads_dtf
@@ -90,7 +98,12 @@ template<typename T>
 class OptionalPtr<T, SyncMode::Sync> {
 public:
     OptionalPtr(T* ptr, std::shared_timed_mutex& mtx) 
-    : ptr_(ptr), lock_(mtx) {
+    : lock_(mtx), ptr_(ptr) {
+    }
+
+    // no data, so nothing is locked
+    explicit OptionalPtr(std::nullptr_t) 
+    : ptr_(nullptr) {
     }
 
     ~OptionalPtr() = default;
@@ -137,8 +150,13 @@ private:
 template<typename T>
 class OptionalPtr<const T, SyncMode::Sync> {
 public:
-    OptionalPtr(T* ptr, std::shared_timed_mutex& mtx) 
-    : ptr_(ptr), lock_(mtx)  {
+    OptionalPtr(const T* ptr, std::shared_timed_mutex& mtx) 
+    : lock_(mtx), ptr_(ptr) {
+    }
+
+    // no data, so nothing is locked
+    explicit OptionalPtr(std::nullptr_t) 
+    : ptr_(nullptr) {
     }
 
     ~OptionalPtr() = default;
@@ -183,6 +201,321 @@ private:
     const T* ptr_;
 };
 
+// Writer of seqlock data: edits go to a private copy that is published to the
+// readers when the pointer is released. Other writers wait, readers never do.
+template<typename T>
+class OptionalPtr<T, SyncMode::SeqLock> {
+public:
+    // takes over the held writer lock of seqLock, target is the guarded value
+    OptionalPtr(std::unique_lock<std::mutex> writer, SeqLock& seqLock, T& target, bool& present)
+    : writer_(std::move(writer)), seqLock_(&seqLock), target_(&target), present_(&present) {
+        if (present) {
+            std::memcpy(&value_, &target, sizeof(T));
+        }
+    }
+
+    // no data, so nothing is locked
+    explicit OptionalPtr(std::nullptr_t) {
+    }
+
+    ~OptionalPtr() {
+        Publish();
+    }
+
+    OptionalPtr(const OptionalPtr& other) = delete;
+    OptionalPtr& operator=(const OptionalPtr& other) = delete;
+
+    OptionalPtr(OptionalPtr&& other) noexcept {
+        Take(other);
+    }
+
+    OptionalPtr& operator=(OptionalPtr&& other) noexcept {
+        if (this != &other) {
+            Publish();
+            Take(other);
+        }
+        return *this;
+    }
+
+    bool HasValue() const { return seqLock_ != nullptr; }
+    explicit operator bool() const { return HasValue(); }
+    T* Get() { return HasValue() ? reinterpret_cast<T*>(&value_) : nullptr; }
+
+    T* operator->() {
+        assert(HasValue() && "OptionalPtr is null. Assertion failed.");
+        return Get();
+    }
+
+    T& operator*() { 
+        return *Get(); 
+    }
+
+    template<typename Handle, typename Fail>
+    void Match(Handle& handle, Fail& fail) {
+        if (HasValue()) {
+            handle(*Get());
+        } else {
+            fail();
+        }
+    }
+
+    template<typename Handle>
+    void Apply(Handle& handle) {
+        assert(HasValue() && "OptionalPtr is null. Assertion failed.");
+        handle(*Get());
+    }
+
+private:
+    void Publish() {
+        if (!seqLock_) {
+            return;
+        }
+        seqLock_->WriteBegin();
+        seq_store(&value_, *target_);
+        __atomic_store_n(present_, true, __ATOMIC_RELAXED);
+        seqLock_->WriteEnd();
+        seqLock_ = nullptr;
+        writer_ = std::unique_lock<std::mutex>();
+    }
+
+    void Take(OptionalPtr& other) {
+        writer_ = std::move(other.writer_);
+        seqLock_ = other.seqLock_;
+        target_ = other.target_;
+        present_ = other.present_;
+        std::memcpy(&value_, &other.value_, sizeof(T));
+        other.seqLock_ = nullptr;
+    }
+
+private:
+    std::unique_lock<std::mutex> writer_;
+    SeqLock* seqLock_{nullptr};
+    T* target_{nullptr};
+    bool* present_{nullptr};
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type value_;
+};
+
+// Reader of seqlock data: holds a consistent copy taken without blocking the
+// writer, so it stays valid however long the reader keeps it.
+template<typename T>
+class OptionalPtr<const T, SyncMode::SeqLock> {
+public:
+    // copies source out again whenever a write overlapped the copy
+    OptionalPtr(const SeqLock& seqLock, const T& source, const bool& present) {
+        std::uint32_t sequence;
+        do {
+            sequence = seqLock.ReadBegin();
+            hasValue_ = __atomic_load_n(&present, __ATOMIC_RELAXED);
+            if (hasValue_) {
+                seq_load(source, &value_);
+            }
+        } while (seqLock.ReadRetry(sequence));
+    }
+
+    explicit OptionalPtr(std::nullptr_t) {
+    }
+
+    bool HasValue() const { return hasValue_; }
+    explicit operator bool() const { return HasValue(); }
+    const T* Get() const { return hasValue_ ? reinterpret_cast<const T*>(&value_) : nullptr; }
+
+    const T* operator->() const {
+        assert(hasValue_ && "OptionalPtr is null. Assertion failed.");
+        return Get();
+    }
+
+    const T& operator*() const { 
+        return *Get(); 
+    }
+
+    template<typename Handle, typename Fail>
+    void Match(const Handle& handle, const Fail& fail) const {
+        if (hasValue_) {
+            handle(*Get());
+        } else {
+            fail();
+        }
+    }
+
+    template<typename Handle>
+    void Apply(const Handle& handle) const {
+        assert(hasValue_ && "OptionalPtr is null. Assertion failed.");
+        handle(*Get());
+    }
+
+private:
+    bool hasValue_{false};
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type value_;
+};
+
+// Writer of RCU data: edits a new version built off to the side, which
+// replaces the published one in a single pointer swap when released. The
+// replaced version is retired, readers that pinned it keep using it.
+template<typename T>
+class OptionalPtr<T, SyncMode::Rcu> {
+public:
+    // takes over the held writer lock of version and owns next until publishing it
+    OptionalPtr(std::unique_lock<std::mutex> writer, T* next, std::atomic<T*>& version, RetireList& retired)
+    : writer_(std::move(writer)), next_(next), version_(&version), retired_(&retired) {
+    }
+
+    // no data, so nothing is locked
+    explicit OptionalPtr(std::nullptr_t) {
+    }
+
+    ~OptionalPtr() {
+        Publish();
+    }
+
+    OptionalPtr(const OptionalPtr& other) = delete;
+    OptionalPtr& operator=(const OptionalPtr& other) = delete;
+
+    OptionalPtr(OptionalPtr&& other) noexcept
+    : writer_(std::move(other.writer_)), next_(other.next_), version_(other.version_), retired_(other.retired_) {
+        other.next_ = nullptr;
+    }
+
+    OptionalPtr& operator=(OptionalPtr&& other) noexcept {
+        if (this != &other) {
+            Publish();
+            writer_ = std::move(other.writer_);
+            next_ = other.next_;
+            version_ = other.version_;
+            retired_ = other.retired_;
+            other.next_ = nullptr;
+        }
+        return *this;
+    }
+
+    bool HasValue() const { return next_ != nullptr; }
+    explicit operator bool() const { return HasValue(); }
+    T* Get() { return next_; }
+
+    T* operator->() {
+        assert(next_ && "OptionalPtr is null. Assertion failed.");
+        return next_;
+    }
+
+    T& operator*() { 
+        return *next_; 
+    }
+
+    template<typename Handle, typename Fail>
+    void Match(Handle& handle, Fail& fail) {
+        if (next_) {
+            handle(*next_);
+        } else {
+            fail();
+        }
+    }
+
+    template<typename Handle>
+    void Apply(Handle& handle) {
+        assert(next_ && "OptionalPtr is null. Assertion failed.");
+        handle(*next_);
+    }
+
+private:
+    void Publish() {
+        if (!next_) {
+            return;
+        }
+        T* previous = version_->exchange(next_, std::memory_order_seq_cst);
+        if (previous) {
+            retired_->Retire(previous);
+        }
+        next_ = nullptr;
+        writer_ = std::unique_lock<std::mutex>();
+    }
+
+private:
+    std::unique_lock<std::mutex> writer_;
+    T* next_{nullptr};
+    std::atomic<T*>* version_{nullptr};
+    RetireList* retired_{nullptr};
+};
+
+// Reader of RCU data: pins the published version without blocking anyone,
+// it holds a reader record of the retire list so the version outlives the
+// frame boundary for as long as the reader keeps it.
+template<typename T>
+class OptionalPtr<const T, SyncMode::Rcu> {
+public:
+    OptionalPtr(const std::atomic<T*>& version, const RetireList& retired) : retired_(&retired) {
+        reader_ = retired.EnterRead();
+        ptr_ = version.load(std::memory_order_seq_cst);
+        if (!ptr_) {
+            Release();
+        }
+    }
+
+    explicit OptionalPtr(std::nullptr_t) {
+    }
+
+    ~OptionalPtr() {
+        Release();
+    }
+
+    OptionalPtr(const OptionalPtr& other) = delete;
+    OptionalPtr& operator=(const OptionalPtr& other) = delete;
+
+    OptionalPtr(OptionalPtr&& other) noexcept
+    : ptr_(std::exchange(other.ptr_, nullptr)), retired_(std::exchange(other.retired_, nullptr)), reader_(other.reader_) {
+    }
+
+    OptionalPtr& operator=(OptionalPtr&& other) noexcept {
+        if (this != &other) {
+            Release();
+            ptr_ = std::exchange(other.ptr_, nullptr);
+            retired_ = std::exchange(other.retired_, nullptr);
+            reader_ = other.reader_;
+        }
+        return *this;
+    }
+
+    bool HasValue() const { return ptr_ != nullptr; }
+    explicit operator bool() const { return HasValue(); }
+    const T* Get() const { return ptr_; }
+
+    const T* operator->() const {
+        assert(ptr_ && "OptionalPtr is null. Assertion failed.");
+        return ptr_;
+    }
+
+    const T& operator*() const { 
+        return *ptr_; 
+    }
+
+    template<typename Handle, typename Fail>
+    void Match(const Handle& handle, const Fail& fail) const {
+        if (ptr_) {
+            handle(*ptr_);
+        } else {
+            fail();
+        }
+    }
+
+    template<typename Handle>
+    void Apply(const Handle& handle) const {
+        assert(ptr_ && "OptionalPtr is null. Assertion failed.");
+        handle(*ptr_);
+    }
+
+private:
+    void Release() {
+        if (retired_) {
+            retired_->LeaveRead(reader_);
+        }
+        ptr_ = nullptr;
+        retired_ = nullptr;
+    }
+
+private:
+    const T* ptr_{nullptr};
+    const RetireList* retired_{nullptr};
+    std::size_t reader_{0};
+};
+
 }   // namespace ads_dtf
 
 #endif
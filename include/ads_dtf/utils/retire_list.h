@@ -0,0 +1,139 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef RETIRE_LIST_H
+#define RETIRE_LIST_H
+
+#include "ads_dtf/utils/arena.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ads_dtf {
+
+// Versions replaced by an RCU publish. A reader pins the list epoch in a
+// record of its own, each on a cache line of its own, so readers on several
+// threads never write a shared line. Every Reclaim moves the epoch on and
+// frees the versions retired before the oldest pinned epoch, so readers that
+// come and go never hold reclamation back, while one that keeps its version
+// across a frame boundary keeps it alive.
+struct RetireList {
+    // readers beyond the records fall back to a shared count, while any of
+    // them reads nothing is freed
+    static constexpr std::size_t READERS = 64;
+
+    RetireList() = default;
+
+    ~RetireList() {
+        Free(versions_);
+    }
+
+    RetireList(const RetireList&) = delete;
+    RetireList& operator=(const RetireList&) = delete;
+
+    // called once the version was unpublished
+    template<typename T>
+    void Retire(T* version) {
+        std::uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+        std::lock_guard<std::mutex> lock(mutex_);
+        versions_.push_back(Version{version, [](void* ptr) { delete static_cast<T*>(ptr); }, epoch});
+    }
+
+    // A reader pins the epoch before it loads the published version and gets
+    // back its record for LeaveRead. A version retired at an epoch older than
+    // the pin was unpublished before the reader loaded, it can not hold it.
+    std::size_t EnterRead() const {
+        static thread_local const std::size_t start = std::hash<std::thread::id>()(std::this_thread::get_id()) % READERS;
+        std::uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+        for (std::size_t i = 0; i < READERS; i++) {
+            auto& reader = readers_[(start + i) % READERS];
+            std::uint64_t idle = 0;
+            if (reader.epoch.load(std::memory_order_relaxed) == 0 &&
+                reader.epoch.compare_exchange_strong(idle, epoch, std::memory_order_seq_cst)) {
+                return (start + i) % READERS;
+            }
+        }
+        overflow_.fetch_add(1, std::memory_order_seq_cst);
+        return READERS;
+    }
+
+    void LeaveRead(std::size_t reader) const {
+        if (reader == READERS) {
+            overflow_.fetch_sub(1, std::memory_order_release);
+        } else {
+            readers_[reader].epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    // returns how many versions were freed
+    std::size_t Reclaim() {
+        std::vector<Version> versions;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            versions.swap(versions_);
+        }
+
+        // readers pinning from now on are newer than every version taken above
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        std::uint64_t oldest = overflow_.load(std::memory_order_seq_cst) != 0 ? 0 : std::numeric_limits<std::uint64_t>::max();
+        for (auto& reader : readers_) {
+            std::uint64_t epoch = reader.epoch.load(std::memory_order_seq_cst);
+            if (epoch != 0) {
+                oldest = std::min(oldest, epoch);
+            }
+        }
+
+        auto stale = std::partition(versions.begin(), versions.end(), [oldest](const Version& version) {
+            return version.epoch >= oldest;
+        });
+        std::vector<Version> freed(stale, versions.end());
+        versions.erase(stale, versions.end());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            versions_.insert(versions_.end(), versions.begin(), versions.end());
+        }
+        return Free(freed);
+    }
+
+    std::size_t Size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return versions_.size();
+    }
+
+private:
+    struct Version {
+        void* ptr;
+        void (*free)(void* ptr);
+        std::uint64_t epoch;
+    };
+
+    struct alignas(CACHE_LINE_SIZE) Reader {
+        std::atomic<std::uint64_t> epoch{0};
+    };
+
+    static std::size_t Free(std::vector<Version>& versions) {
+        for (auto& version : versions) {
+            version.free(version.ptr);
+        }
+        return versions.size();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<Version> versions_;
+    // 0 marks an idle reader record, so the epoch starts at 1
+    std::atomic<std::uint64_t> epoch_{1};
+    mutable Reader readers_[READERS];
+    alignas(CACHE_LINE_SIZE) mutable std::atomic<std::size_t> overflow_{0};
+};
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace ads_dtf {
+
+// Sequence counter of a seqlock, odd while a write is in progress. Readers
+// copy the guarded value and retry when the counter moved meanwhile, writers
+// are serialized by Writer() and never wait for readers.
+struct SeqLock {
+    std::uint32_t ReadBegin() const {
+        std::uint32_t sequence = sequence_.load(std::memory_order_acquire);
+        while (sequence & 1) {
+            std::this_thread::yield();
+            sequence = sequence_.load(std::memory_order_acquire);
+        }
+        return sequence;
+    }
+
+    bool ReadRetry(std::uint32_t sequence) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence_.load(std::memory_order_relaxed) != sequence;
+    }
+
+    // the caller holds Writer()
+    void WriteBegin() {
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void WriteEnd() {
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    std::mutex& Writer() {
+        return writer_;
+    }
+
+private:
+    std::atomic<std::uint32_t> sequence_{0};
+    std::mutex writer_;
+};
+
+namespace seq_detail {
+    // the widest word that divides the size and keeps the alignment of T
+    template<typename T>
+    using Word = std::conditional_t<sizeof(T) % 8 == 0 && alignof(T) >= 8, std::uint64_t,
+                 std::conditional_t<sizeof(T) % 4 == 0 && alignof(T) >= 4, std::uint32_t,
+                 std::conditional_t<sizeof(T) % 2 == 0 && alignof(T) >= 2, std::uint16_t, std::uint8_t>>>;
+}
+
+// Copies racing with a writer are made word by word with relaxed atomics, so
+// a torn copy is well defined and only ever discarded by the retry.
+template<typename T>
+void seq_load(const T& from, void* to) {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock data must be trivially copyable");
+    using Word = seq_detail::Word<T>;
+    auto source = reinterpret_cast<const Word*>(&from);
+    for (std::size_t i = 0; i < sizeof(T) / sizeof(Word); i++) {
+        Word word = __atomic_load_n(source + i, __ATOMIC_RELAXED);
+        std::memcpy(static_cast<char*>(to) + i * sizeof(Word), &word, sizeof(Word));
+    }
+}
+
+template<typename T>
+void seq_store(const void* from, T& to) {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock data must be trivially copyable");
+    using Word = seq_detail::Word<T>;
+    auto target = reinterpret_cast<Word*>(&to);
+    for (std::size_t i = 0; i < sizeof(T) / sizeof(Word); i++) {
+        Word word;
+        std::memcpy(&word, static_cast<const char*>(from) + i * sizeof(Word), sizeof(Word));
+        __atomic_store_n(target + i, word, __ATOMIC_RELAXED);
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,242 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "ads_dtf/utils/arena.h"
+#include "ads_dtf/utils/placement.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace ads_dtf {
+
+enum class StreamMode {
+    Spsc,   // one producer thread and one consumer thread
+    Mpmc,   // any number of both
+};
+
+template<typename STREAM>
+struct StreamProducer;
+
+template<typename STREAM>
+struct StreamConsumer;
+
+// Bounded lock-free ring of CAPACITY preallocated slots, each on its own cache
+// line. Every slot carries a sequence number telling whether it is free for the
+// push or filled for the pop of the current lap, so the two sides only share
+// the slots they hand over. Mpmc claims positions with a CAS, Spsc with a store.
+//
+// Registered like any Cache or Global data, Fetch gives its creator and
+// writers a Producer and its readers a Consumer.
+template<typename T, std::size_t CAPACITY, StreamMode MODE = StreamMode::Spsc>
+struct Stream {
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0, "Stream capacity must be a power of two");
+
+    using value_type = T;
+    using Producer = StreamProducer<Stream>;
+    using Consumer = StreamConsumer<Stream>;
+
+    Stream() {
+        for (std::size_t i = 0; i < CAPACITY; i++) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~Stream() {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        while (slots_[pos & MASK].sequence.load(std::memory_order_relaxed) == pos + 1) {
+            slots_[pos & MASK].value.Destroy();
+            pos++;
+        }
+    }
+
+    Stream(const Stream&) = delete;
+    Stream& operator=(const Stream&) = delete;
+
+    // false when the stream is full
+    template<typename... ARGs>
+    bool TryPush(ARGs&&... args) {
+        std::size_t pos = 0;
+        if (!Claim(tail_, pos, 0, 1)) {
+            return false;
+        }
+        Slot& slot = slots_[pos & MASK];
+        new (slot.value.Alloc()) T(std::forward<ARGs>(args)...);
+        slot.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // false when the stream is empty
+    bool TryPop(T& out) {
+        std::size_t pos = 0;
+        if (!Claim(head_, pos, 1, 1)) {
+            return false;
+        }
+        Slot& slot = slots_[pos & MASK];
+        out = std::move(*slot.value);
+        slot.value.Destroy();
+        slot.sequence.store(pos + CAPACITY, std::memory_order_release);
+        return true;
+    }
+
+    // Claims the run of free slots from the tail, up to count of them, in one
+    // step and fills it from first on. Returns how many were pushed.
+    template<typename ITER>
+    std::size_t TryPushBatch(ITER first, std::size_t count) {
+        std::size_t pos = 0;
+        std::size_t claimed = Claim(tail_, pos, 0, count);
+        for (std::size_t i = 0; i < claimed; i++, ++first) {
+            Slot& slot = slots_[(pos + i) & MASK];
+            new (slot.value.Alloc()) T(*first);
+            slot.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return claimed;
+    }
+
+    // Claims the run of filled slots from the head, up to max of them, in one
+    // step and drains it into out. Returns how many were popped.
+    template<typename OUT>
+    std::size_t TryPopBatch(OUT out, std::size_t max) {
+        std::size_t pos = 0;
+        std::size_t claimed = Claim(head_, pos, 1, max);
+        for (std::size_t i = 0; i < claimed; i++, ++out) {
+            Slot& slot = slots_[(pos + i) & MASK];
+            *out = std::move(*slot.value);
+            slot.value.Destroy();
+            slot.sequence.store(pos + i + CAPACITY, std::memory_order_release);
+        }
+        return claimed;
+    }
+
+    // a snapshot, other threads may have moved on already
+    std::size_t SizeApprox() const {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        auto head = head_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    static constexpr std::size_t Capacity() {
+        return CAPACITY;
+    }
+
+private:
+    static constexpr std::size_t MASK = CAPACITY - 1;
+
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<std::size_t> sequence{0};
+        Placement<T> value;
+    };
+
+    // Claims up to max consecutive positions of one side with a single store or
+    // CAS, a slot is ready when its sequence equals its position + lag. The
+    // first one is at pos, returns how many were claimed, 0 when the ring is
+    // full or empty.
+    std::size_t Claim(std::atomic<std::size_t>& position, std::size_t& pos, std::size_t lag, std::size_t max) {
+        if (max == 0) {
+            return 0;
+        }
+        pos = position.load(std::memory_order_relaxed);
+        while (true) {
+            auto diff = std::intptr_t(slots_[pos & MASK].sequence.load(std::memory_order_acquire)) - std::intptr_t(pos + lag);
+            if (diff < 0) {
+                return 0;
+            }
+            if (diff > 0) {
+                pos = position.load(std::memory_order_relaxed);
+                continue;
+            }
+            // the slots after the first are ready as long as nobody claims pos
+            std::size_t count = 1;
+            while (count < std::min(max, CAPACITY) &&
+                   slots_[(pos + count) & MASK].sequence.load(std::memory_order_acquire) == pos + count + lag) {
+                count++;
+            }
+            if constexpr (MODE == StreamMode::Spsc) {
+                position.store(pos + count, std::memory_order_relaxed);
+                return count;
+            } else if (position.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+                return count;
+            }
+        }
+    }
+
+private:
+    Slot slots_[CAPACITY];
+    // next position to push and to pop, each on a line of its own
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_{0};
+};
+
+// The pushing end of a stream, empty when the stream could not be fetched.
+template<typename STREAM>
+struct StreamProducer {
+    using T = typename STREAM::value_type;
+
+    explicit StreamProducer(STREAM* stream) : stream_(stream) {}
+
+    bool HasValue() const { return stream_ != nullptr; }
+    explicit operator bool() const { return HasValue(); }
+
+    template<typename... ARGs>
+    bool Push(ARGs&&... args) {
+        assert(stream_ && "StreamProducer is null. Assertion failed.");
+        return stream_->TryPush(std::forward<ARGs>(args)...);
+    }
+
+    // pushes from [first, last) until the stream is full, returns how many
+    // pushes from [first, last) as far as the stream has room, in one claim;
+    // returns how many
+    template<typename ITER>
+    std::size_t PushBatch(ITER first, ITER last) {
+        assert(stream_ && "StreamProducer is null. Assertion failed.");
+        return stream_->TryPushBatch(first, std::size_t(std::distance(first, last)));
+    }
+
+private:
+    STREAM* stream_;
+};
+
+// The popping end of a stream, empty when the stream could not be fetched.
+template<typename STREAM>
+struct StreamConsumer {
+    using T = typename STREAM::value_type;
+
+    explicit StreamConsumer(STREAM* stream) : stream_(stream) {}
+
+    bool HasValue() const { return stream_ != nullptr; }
+    explicit operator bool() const { return HasValue(); }
+
+    bool Pop(T& out) {
+        assert(stream_ && "StreamConsumer is null. Assertion failed.");
+        return stream_->TryPop(out);
+    }
+
+    // pops up to max items into the ones out points to in one claim, fewer
+    // when the stream holds fewer; returns how many
+    template<typename OUT>
+    std::size_t PopBatch(OUT out, std::size_t max) {
+        assert(stream_ && "StreamConsumer is null. Assertion failed.");
+        return stream_->TryPopBatch(out, max);
+    }
+
+private:
+    STREAM* stream_;
+};
+
+template<typename T>
+struct is_stream : std::false_type {};
+
+template<typename T, std::size_t CAPACITY, StreamMode MODE>
+struct is_stream<Stream<T, CAPACITY, MODE>> : std::true_type {};
+
+}
+
+#endif
@@ -11,6 +11,8 @@ namespace ads_dtf
 enum class SyncMode {
     None,
     Sync,
+    SeqLock,
+    Rcu,
 };
 
 }
@@ -0,0 +1,37 @@
+/**
+* Copyright (c) wangbo@joycode.art 2024
+*/
+
+#ifndef TYPE_NAME_H
+#define TYPE_NAME_H
+
+#include <string_view>
+
+namespace ads_dtf {
+
+// Readable name of T taken from the compiler's function signature, for
+// reports only; it is not guaranteed to be stable across compilers.
+template <typename T>
+constexpr std::string_view TypeNameOf() {
+#if defined(__clang__) || defined(__GNUC__)
+    std::string_view signature = __PRETTY_FUNCTION__;
+    auto begin = signature.find("T = ");
+    if (begin == std::string_view::npos) {
+        return "unknown";
+    }
+    begin += 4;
+    // no type name holds a ';', but arrays hold a ']': GCC ends T at the
+    // first ';', clang at the last ']'
+    auto end = signature.find(';', begin);
+    if (end == std::string_view::npos) {
+        end = signature.rfind(']');
+    }
+    return signature.substr(begin, end - begin);
+#else
+    return "unknown";
+#endif
+}
+
+}
+
+#endif
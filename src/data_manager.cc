@@ -1,17 +1,400 @@
 #include "ads_dtf/dtf/data_manager.h"
 #include "ads_dtf/dtf/data_context.h"
+#include <cstdlib>
+#include <fstream>
 
 namespace ads_dtf {
 
+DataManager::DataRepo::~DataRepo() {
+    for (SlotIndex slot = 0; slot < objects_.size(); slot++) {
+        if (objects_[slot] && (!IsShared(slot) || owners_[groupOf_[slot]] == slot)) {
+            ops_[slot]->destroy(objects_[slot]);
+        }
+    }
+}
+
+void DataManager::DataRepo::Reset() {
+    epoch_.fetch_add(1, std::memory_order_relaxed);
+
+    // shared data lives for one frame, the next access builds it afresh
+    for (auto& owner : owners_) {
+        if (owner != INVALID_SLOT) {
+            ops_[owner]->destroy(objects_[owner]);
+            owner = INVALID_SLOT;
+        }
+    }
+
+    // objects with nothing to clear are only counted, a word at a time
+    std::size_t cleared = 0;
+    for (std::size_t i = 0; i < dirty_.WordCount(); i++) {
+        auto word = (dirty_.TakeWord(i) | pinned_.GetWord(i)) & ~shared_.GetWord(i) & clearable_.GetWord(i);
+        cleared += __builtin_popcountll(word);
+        DynamicBitset::ForEachBit(word, i * DynamicBitset::WORD_BITS, [this](std::size_t slot) {
+            ops_[slot]->clear(objects_[slot]);
+        });
+    }
+
+    lastReset_.cleared = cleared;
+    lastReset_.skipped = count_ - cleared;
+}
+
+void DataManager::DataRepo::Seal(const std::vector<std::vector<SlotIndex>>& groups) {
+    shared_.Resize(objects_.size());
+    groupOf_.assign(objects_.size(), 0);
+    for (std::size_t group = 0; group < groups.size(); group++) {
+        for (auto slot : groups[group]) {
+            shared_.Set(slot);
+            groupOf_[slot] = group;
+        }
+    }
+
+    // a group takes the size and alignment of its largest member
+    std::vector<std::size_t> groupSizes(groups.size(), 0);
+    std::vector<std::size_t> groupAligns(groups.size(), 1);
+    std::size_t size = 0;
+    for (SlotIndex slot = 0; slot < objects_.size(); slot++) {
+        if (!objects_[slot] || !arena_.Contains(objects_[slot])) continue;
+        if (IsShared(slot)) {
+            groupSizes[groupOf_[slot]] = std::max(groupSizes[groupOf_[slot]], layouts_[slot].size);
+            groupAligns[groupOf_[slot]] = std::max(groupAligns[groupOf_[slot]], layouts_[slot].align);
+        } else {
+            size = align_up(size, layouts_[slot].align) + layouts_[slot].size;
+        }
+    }
+    std::vector<std::size_t> groupOffsets(groups.size(), 0);
+    for (std::size_t group = 0; group < groups.size(); group++) {
+        groupOffsets[group] = align_up(size, groupAligns[group]);
+        size = groupOffsets[group] + groupSizes[group];
+    }
+
+    if (size == 0) {
+        arena_ = Arena();
+    } else if (size < arena_.Capacity() || !groups.empty()) {
+        Arena arena(size, arena_.Alignment());
+        if (!arena.Data()) {
+            // keep the current layout, unshared
+            shared_.ResetAll();
+            used_ = size;
+            return;
+        }
+
+        std::size_t offset = 0;
+        for (SlotIndex slot = 0; slot < objects_.size(); slot++) {
+            if (!objects_[slot] || !arena_.Contains(objects_[slot])) continue;
+            if (IsShared(slot)) {
+                // shared data is built on first access in each frame
+                ops_[slot]->destroy(objects_[slot]);
+                objects_[slot] = arena.Data() + groupOffsets[groupOf_[slot]];
+            } else {
+                offset = align_up(offset, layouts_[slot].align);
+                objects_[slot] = ops_[slot]->moveTo(objects_[slot], arena.Data() + offset);
+                offset += layouts_[slot].size;
+            }
+        }
+        arena_ = std::move(arena);
+    }
+    used_ = size;
+    owners_.assign(groups.size(), INVALID_SLOT);
+
+    objects_.shrink_to_fit();
+    ops_.shrink_to_fit();
+    layouts_.shrink_to_fit();
+}
+
+void DataManager::DataRepo::Plan(MemoryPlan::Span& plan) const {
+    plan = MemoryPlan::Span();
+    plan.arenaBytes = arena_.Capacity();
+    for (auto& region : regions_) {
+        plan.mappedBytes += region.Size();
+    }
+    for (auto& block : fixed_) {
+        plan.fixedBytes += block.Capacity();
+    }
+    for (auto& arena : nodeArenas_) {
+        plan.nodeBytes += arena.Size();
+    }
+
+    std::vector<std::size_t> groupBytes(owners_.size(), 0);
+    for (SlotIndex slot = 0; slot < objects_.size(); slot++) {
+        if (!objects_[slot]) continue;
+
+        auto& layout = layouts_[slot];
+        MemoryPlan::Entry entry;
+        entry.name = layout.name;
+        entry.slot = slot;
+        entry.size = layout.dataSize;
+        entry.align = layout.dataAlign;
+        entry.capacity = layout.capacity;
+        entry.history = layout.depth;
+        entry.objectSize = layout.size;
+        entry.objectAlign = layout.align;
+        entry.bookkeeping = layout.bookkeeping;
+        entry.padding = layout.size - layout.storedSize * layout.capacity * layout.depth - layout.bookkeeping;
+
+        if (IsShared(slot)) {
+            entry.storage = "shared";
+            plan.sharedSavedBytes += layout.size;
+            groupBytes[groupOf_[slot]] = std::max(groupBytes[groupOf_[slot]], layout.size);
+        } else if (arena_.Contains(objects_[slot])) {
+            entry.storage = "arena";
+        } else if (std::any_of(regions_.begin(), regions_.end(), [this, slot](const MappedRegion& region) {
+                       return region.Data() == static_cast<char*>(objects_[slot]);
+                   })) {
+            entry.storage = "mapped";
+        } else if (IsFixed(slot)) {
+            entry.storage = "fixed";
+        } else {
+            entry.storage = "node";
+        }
+        if (arena_.Contains(objects_[slot])) {
+            entry.offset = static_cast<char*>(objects_[slot]) - arena_.Data();
+        }
+
+        plan.dataBytes += layout.storedSize * layout.capacity * layout.depth;
+        plan.entries.push_back(entry);
+    }
+    for (auto bytes : groupBytes) {
+        plan.sharedSavedBytes -= bytes;
+    }
+}
+
+void DataManager::DataRepo::Eliminate(SlotIndex slot) {
+    if (slot >= objects_.size() || !objects_[slot]) return;
+
+    void* object = objects_[slot];
+    ops_[slot]->destroy(object);
+    regions_.erase(std::remove_if(regions_.begin(), regions_.end(), [object](const MappedRegion& region) {
+        return region.Data() == static_cast<char*>(object);
+    }), regions_.end());
+    fixed_.erase(std::remove_if(fixed_.begin(), fixed_.end(), [object](const Arena& block) {
+        return block.Data() == static_cast<char*>(object);
+    }), fixed_.end());
+
+    objects_[slot] = nullptr;
+    ops_[slot] = nullptr;
+    count_--;
+    dirty_.Reset(slot);
+    pinned_.Reset(slot);
+    clearable_.Reset(slot);
+    eliminated_.Set(slot);
+}
+
+bool DataManager::DataRepo::Reallocate(std::size_t capacity, std::size_t alignment) {
+    Arena arena(capacity, alignment);
+    if (!arena.Data()) {
+        return false;
+    }
+
+    // offsets are kept, the new arena is at least as aligned as the old one
+    for (SlotIndex slot = 0; slot < objects_.size(); slot++) {
+        if (objects_[slot] && arena_.Contains(objects_[slot])) {
+            auto offset = static_cast<char*>(objects_[slot]) - arena_.Data();
+            objects_[slot] = ops_[slot]->moveTo(objects_[slot], arena.Data() + offset);
+        }
+    }
+    arena_ = std::move(arena);
+    return true;
+}
+
+void DataManager::DataRepo::PlaceOnNodes(const std::vector<int>& requested) {
+    int nodeCount = numa_node_count();
+
+    // objects without a valid node stay where they are, even in a node arena,
+    // and so does immovable data and data aligned beyond a page
+    std::vector<int> nodes(objects_.size(), NUMA_NODE_ANY);
+    for (SlotIndex slot = 0; slot < objects_.size(); slot++) {
+        if (!objects_[slot] || IsFixed(slot) || layouts_[slot].align > NUMA_PAGE_SIZE) continue;
+        int node = (slot < requested.size()) ? requested[slot] : NUMA_NODE_ANY;
+        nodes[slot] = (node >= 0 && node < nodeCount) ? node : layouts_[slot].node;
+    }
+
+    std::vector<NodeRegion> nodeArenas;
+    for (int node = 0; node < nodeCount; node++) {
+        std::size_t size = 0;
+        for (SlotIndex slot = 0; slot < objects_.size(); slot++) {
+            if (!objects_[slot] || nodes[slot] != node) continue;
+            size = align_up(size, layouts_[slot].align) + layouts_[slot].size;
+        }
+        if (size == 0) continue;
+
+        // mapped and bound before the objects move in, so their pages are
+        // first touched on node; nothing is moved where binding fails
+        NodeRegion arena(size, node);
+        if (!arena.Data()) continue;
+
+        std::size_t offset = 0;
+        for (SlotIndex slot = 0; slot < objects_.size(); slot++) {
+            if (!objects_[slot] || nodes[slot] != node) continue;
+
+            offset = align_up(offset, layouts_[slot].align);
+            auto mapped = std::find_if(regions_.begin(), regions_.end(), [this, slot](const MappedRegion& region) {
+                return region.Data() == static_cast<char*>(objects_[slot]);
+            });
+            if (mapped != regions_.end()) {
+                // huge page data keeps its own mapping, its pages are migrated instead
+                numa_bind(mapped->Data(), mapped->Size(), node);
+            } else {
+                objects_[slot] = ops_[slot]->moveTo(objects_[slot], arena.Data() + offset);
+                offset += layouts_[slot].size;
+            }
+            layouts_[slot].node = node;
+        }
+        nodeArenas.push_back(std::move(arena));
+    }
+    nodeArenas_ = std::move(nodeArenas);
+}
+
+void DataManager::PlaceOnNodes(const NumaNodeMap& nodeMap) {
+    if (sealed_) {
+        std::cout << "Registration is sealed, data stays in place" << std::endl;
+        return;
+    }
+
+    for (int i = 0; i < enum_id_cast(LifeSpan::Max); i++) {
+        LifeSpan span = static_cast<LifeSpan>(i);
+        DataRepo& repo = repos_[i];
+
+        std::vector<int> nodes(repo.SlotCount(), NUMA_NODE_ANY);
+        for (SlotIndex slot = 0; slot < repo.SlotCount(); slot++) {
+            if (!repo.At(slot)) continue;
+
+            int writerNode = NUMA_NODE_ANY;
+            for (auto& entry : nodeMap.Entries()) {
+                auto mode = acl_.GetAccessMode(entry.first, span, slot);
+                if (mode == AccessMode::Create) {
+                    nodes[slot] = entry.second;
+                    break;
+                }
+                if (mode == AccessMode::Write && writerNode == NUMA_NODE_ANY) {
+                    writerNode = entry.second;
+                }
+            }
+            if (nodes[slot] == NUMA_NODE_ANY) {
+                nodes[slot] = writerNode;
+            }
+        }
+        repo.PlaceOnNodes(nodes);
+    }
+}
+
+void DataManager::Seal(const ProcessorOrder& order) {
+    if (sealed_) return;
+
+    for (int i = 0; i < enum_id_cast(LifeSpan::Max); i++) {
+        LifeSpan span = static_cast<LifeSpan>(i);
+        DataRepo& repo = repos_[i];
+
+        for (SlotIndex slot = 0; slot < DataSlotCounter::Count(span); slot++) {
+            // a creator may read its own data back, only a droppable one is dropped
+            auto usage = acl_.GetColumnUsage(span, slot);
+            if (usage.creators > 0 && usage.readers == 0 && usage.writers == 0 && repo.IsDroppable(slot)) {
+                std::cout << "Dropped dtype " << acl_.TypeOf(span, slot) << " of lifespan " << i
+                          << ", it has no reader or writer" << std::endl;
+                repo.Eliminate(slot);
+            } else if (usage.creators == 0 && (usage.readers > 0 || usage.writers > 0)) {
+                std::cout << "Warning: dtype " << acl_.TypeOf(span, slot) << " of lifespan " << i
+                          << " has " << (usage.readers + usage.writers) << " readers or writers but no creator" << std::endl;
+            }
+        }
+        repo.Seal(span == LifeSpan::Frame ? PlanSharing(order) : std::vector<std::vector<SlotIndex>>());
+        repo.Plan(plan_.spans[i]);
+    }
+
+    if (const char* path = std::getenv("ADS_DTF_MEMORY_REPORT")) {
+        std::ofstream report(path);
+        plan_.WriteJson(report);
+    }
+    acl_.Seal();
+    sealed_ = true;
+}
+
+std::vector<std::vector<SlotIndex>> DataManager::PlanSharing(const ProcessorOrder& order) const {
+    struct Interval {
+        SlotIndex slot;
+        std::size_t first;
+        std::size_t last;
+    };
+
+    const DataRepo& repo = repos_[enum_id_cast(LifeSpan::Frame)];
+    const auto& users = order.Users();
+
+    // a slot is live from the first to the last processor touching it, and
+    // only when every user registered for it runs within the order and the
+    // first one creates it, as only Create takes over the bytes of a group
+    std::vector<Interval> intervals;
+    for (SlotIndex slot = 0; slot < repo.SlotCount(); slot++) {
+        if (!repo.IsShareable(slot)) continue;
+
+        Interval interval{slot, users.size(), 0};
+        std::size_t ordered = 0;
+        for (std::size_t step = 0; step < users.size(); step++) {
+            if (acl_.GetAccessMode(users[step], LifeSpan::Frame, slot) == AccessMode::None) continue;
+            interval.first = std::min(interval.first, step);
+            interval.last = std::max(interval.last, step);
+            if (std::find(users.begin(), users.begin() + step, users[step]) == users.begin() + step) {
+                ordered++;
+            }
+        }
+
+        auto usage = acl_.GetColumnUsage(LifeSpan::Frame, slot);
+        if (ordered > 0 && ordered == usage.creators + usage.writers + usage.readers &&
+            acl_.GetAccessMode(users[interval.first], LifeSpan::Frame, slot) == AccessMode::Create) {
+            intervals.push_back(interval);
+        }
+    }
+    std::sort(intervals.begin(), intervals.end(), [](const Interval& lhs, const Interval& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    // linear scan: a slot joins the best fitting group whose last member dies
+    // before it is born, data touched by the same processor never shares
+    struct Group {
+        std::vector<SlotIndex> slots;
+        std::size_t size;
+        std::size_t last;
+    };
+    std::vector<Group> groups;
+    for (auto& interval : intervals) {
+        std::size_t size = repo.SizeAt(interval.slot);
+        // the smallest group it fits in, otherwise the largest one it grows least
+        auto better = [size](const Group& lhs, const Group& rhs) {
+            bool lhsFits = lhs.size >= size;
+            bool rhsFits = rhs.size >= size;
+            if (lhsFits != rhsFits) return lhsFits;
+            return lhsFits ? (lhs.size < rhs.size) : (lhs.size > rhs.size);
+        };
+
+        Group* best = nullptr;
+        for (auto& group : groups) {
+            if (group.last < interval.first && (!best || better(group, *best))) {
+                best = &group;
+            }
+        }
+        if (best) {
+            best->slots.push_back(interval.slot);
+            best->size = std::max(best->size, size);
+            best->last = interval.last;
+        } else {
+            groups.push_back(Group{{interval.slot}, size, interval.last});
+        }
+    }
+
+    std::vector<std::vector<SlotIndex>> shared;
+    for (auto& group : groups) {
+        if (group.slots.size() > 1) {
+            shared.push_back(std::move(group.slots));
+        }
+    }
+    return shared;
+}
+
 void DataManager::ResetRepo(LifeSpan span) {
     if (span >= LifeSpan::Max) return;
 
-    DataRepo& repo = repos_[enum_id_cast(span)];
-    for (auto& pair : repo) {
-        auto& dtype = pair.first;
-        std::unique_ptr<DataObjectBase>& dataObjPtr = pair.second;
-        dataObjPtr->Clear();
+    repos_[enum_id_cast(span)].Reset();
+    if (span == LifeSpan::Frame) {
+        retired_.Reclaim();
     }
 }
 
-} // namespace ads_dtf
\ No newline at end of file
+} // namespace ads_dtf
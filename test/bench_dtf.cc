@@ -0,0 +1,344 @@
+#include "catch2/catch.hpp"
+#include "ads_dtf/dtf/data_framework.h"
+#include "ads_dtf/dtf/permission_register.h"
+#include "ads_dtf/dtf/static_pipeline.h"
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+using namespace ads_dtf;
+
+//////////////////////////////////////////////////////////////////
+struct PackedCounterA {
+    std::uint64_t count{0};
+};
+
+struct PackedCounterB {
+    std::uint64_t count{0};
+};
+
+struct IsolatedCounterA {
+    std::uint64_t count{0};
+};
+
+struct IsolatedCounterB {
+    std::uint64_t count{0};
+};
+
+struct BenchWriterA {};
+struct BenchWriterB {};
+
+PERMISSION_REGISTER_FOR_CREATE(BenchWriterA, Cache, PackedCounterA, 1);
+PERMISSION_REGISTER_FOR_CREATE(BenchWriterB, Cache, PackedCounterB, 1);
+PERMISSION_REGISTER_FOR_CREATE_OPT(BenchWriterA, Cache, IsolatedCounterA, 1, DataOption::CacheLineIsolated);
+PERMISSION_REGISTER_FOR_CREATE_OPT(BenchWriterB, Cache, IsolatedCounterB, 1, DataOption::CacheLineIsolated);
+
+namespace {
+    constexpr std::size_t WRITE_TIMES = 1000000;
+
+    template<typename COUNTER>
+    void WriteCounter(COUNTER* counter) {
+        volatile std::uint64_t& count = counter->count;
+        for (std::size_t i = 0; i < WRITE_TIMES; i++) {
+            count = count + 1;
+        }
+    }
+
+    template<typename A, typename B>
+    void WriteConcurrently(A* a, B* b) {
+        std::thread writerA([a] { WriteCounter(a); });
+        std::thread writerB([b] { WriteCounter(b); });
+        writerA.join();
+        writerB.join();
+    }
+}
+
+TEST_CASE("Cache line isolation of data written by different threads", "[!benchmark]") {
+    auto& context = DataFramework::Instance().GetContext();
+
+    BenchWriterA writerA;
+    BenchWriterB writerB;
+
+    auto packedA = context.Create<PackedCounterA>(&writerA);
+    auto packedB = context.Create<PackedCounterB>(&writerB);
+    auto isolatedA = context.Create<IsolatedCounterA>(&writerA);
+    auto isolatedB = context.Create<IsolatedCounterB>(&writerB);
+
+    REQUIRE((packedA && packedB && isolatedA && isolatedB));
+
+    BENCHMARK("packed objects") {
+        WriteConcurrently(packedA.Get(), packedB.Get());
+    };
+
+    BENCHMARK("cache line isolated objects") {
+        WriteConcurrently(isolatedA.Get(), isolatedB.Get());
+    };
+}
+
+//////////////////////////////////////////////////////////////////
+struct NodeBuffer0 {
+    std::uint64_t values[1 << 20];
+};
+
+struct NodeBuffer1 {
+    std::uint64_t values[1 << 20];
+};
+
+struct BenchNodeWriter0 {};
+struct BenchNodeWriter1 {};
+
+PERMISSION_REGISTER_FOR_CREATE(BenchNodeWriter0, Global, NodeBuffer0, 1);
+PERMISSION_REGISTER_FOR_CREATE(BenchNodeWriter1, Global, NodeBuffer1, 1);
+
+namespace {
+    template<typename BUFFER>
+    void StreamOnNode(BUFFER* buffer, int node) {
+        numa_run_on_node(node);
+        for (int round = 0; round < 4; round++) {
+            for (auto& value : buffer->values) {
+                value += round;
+            }
+        }
+    }
+
+    void StreamFromBothNodes(NodeBuffer0* buffer0, NodeBuffer1* buffer1) {
+        std::thread writer0([buffer0] { StreamOnNode(buffer0, 0); });
+        std::thread writer1([buffer1] { StreamOnNode(buffer1, 1); });
+        writer0.join();
+        writer1.join();
+    }
+}
+
+TEST_CASE("NUMA placement of data written by threads on different nodes", "[!benchmark]") {
+    if (numa_node_count() < 2) {
+        WARN("NUMA placement benchmark needs at least two NUMA nodes");
+        return;
+    }
+
+    auto& manager = DataFramework::Instance().GetManager();
+    auto& context = DataFramework::Instance().GetContext();
+
+    BenchNodeWriter0 writer0;
+    BenchNodeWriter1 writer1;
+
+    BENCHMARK("data on the node of the static initializer") {
+        StreamFromBothNodes(context.Fetch<NodeBuffer0>(&writer0).Get(), context.Fetch<NodeBuffer1>(&writer1).Get());
+    };
+
+    manager.PlaceOnNodes(NumaNodeMap().Bind<BenchNodeWriter0>(0).Bind<BenchNodeWriter1>(1));
+
+    BENCHMARK("data on the node of its writer") {
+        StreamFromBothNodes(context.Fetch<NodeBuffer0>(&writer0).Get(), context.Fetch<NodeBuffer1>(&writer1).Get());
+    };
+}
+
+//////////////////////////////////////////////////////////////////
+struct StageInput {
+    std::uint64_t value{1};
+};
+
+struct StageState {
+    std::uint64_t value{0};
+};
+
+struct StageOutput {
+    std::uint64_t value{0};
+};
+
+struct BenchStageSource {};
+struct BenchStageSink {};
+
+PERMISSION_REGISTER_FOR_CREATE(BenchStageSource, Frame, StageInput, 1);
+PERMISSION_REGISTER_FOR_CREATE(BenchStageSource, Cache, StageState, 1);
+PERMISSION_REGISTER_FOR_CREATE(BenchStageSink, Frame, StageOutput, 1);
+PERMISSION_REGISTER_FOR_READ(BenchStageSink, Frame, StageInput);
+PERMISSION_REGISTER_FOR_WRITE(BenchStageSink, Cache, StageState);
+
+using StagePipeline = StaticPipeline<ProcessorList<BenchStageSource, BenchStageSink>,
+                                     DataList<StageInput, StageOutput>,
+                                     DataList<StageState>>;
+
+namespace {
+    constexpr std::size_t STAGE_RUNS = 100000;
+
+    // the input gathering prologue of a processor, run once per frame
+    template<typename CONTEXT>
+    std::uint64_t RunStage(CONTEXT& context, const BenchStageSink* sink) {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < STAGE_RUNS; i++) {
+            auto input = context.template Fetch<StageInput>(sink);
+            auto state = context.template Fetch<StageState>(sink);
+            auto output = context.template Fetch<StageOutput>(sink);
+            state->value += input->value;
+            output->value = state->value;
+            sum += output->value;
+        }
+        return sum;
+    }
+}
+
+TEST_CASE("Static pipeline storage against the slot based data manager", "[!benchmark]") {
+    auto& context = DataFramework::Instance().GetContext();
+    StagePipeline pipeline;
+    BenchStageSink sink;
+
+    BENCHMARK("DataContext::Fetch") {
+        return RunStage(context, &sink);
+    };
+
+    BENCHMARK("StaticPipeline::Fetch") {
+        return RunStage(pipeline, &sink);
+    };
+}
+
+//////////////////////////////////////////////////////////////////
+template<int ID, bool LAZY>
+struct SyntheticData {
+    std::uint8_t bytes[256 << 10];
+};
+
+struct SyntheticLoader {};
+
+namespace ads_dtf {
+    template<int ID, bool LAZY>
+    struct Permission<SyntheticLoader, SyntheticData<ID, LAZY>, LifeSpan::Global> {
+        constexpr static AccessMode mode = AccessMode::Create;
+        constexpr static bool sync = false;
+    };
+
+    template<int ID, bool LAZY>
+    struct DtypeInfo<SyntheticData<ID, LAZY>, LifeSpan::Global> {
+        constexpr static bool sync = false;
+        constexpr static std::size_t capacity = 1;
+        constexpr static DataOption options = LAZY ? DataOption::Lazy : DataOption::None;
+        constexpr static std::size_t history = 1;
+    };
+}
+
+namespace {
+    constexpr int SYNTHETIC_TYPES = 64;
+
+    template<bool LAZY, int... IDs>
+    void RegisterSynthetic(DataManager& manager, std::integer_sequence<int, IDs...>) {
+        (manager.Apply<SyntheticLoader, SyntheticData<IDs, LAZY>, LifeSpan::Global>(AccessMode::Create), ...);
+    }
+
+    template<bool LAZY>
+    void RegisterSynthetic(DataManager& manager) {
+        RegisterSynthetic<LAZY>(manager, std::make_integer_sequence<int, SYNTHETIC_TYPES>());
+    }
+
+    std::size_t ResidentBytes() {
+        std::size_t pages = 0, resident = 0;
+        FILE* statm = std::fopen("/proc/self/statm", "r");
+        if (!statm) return 0;
+        if (std::fscanf(statm, "%zu %zu", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        std::fclose(statm);
+        return resident * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    }
+
+    template<bool LAZY>
+    std::size_t ResidentGrowthOfRegistration() {
+        auto before = ResidentBytes();
+        DataManager manager;
+        RegisterSynthetic<LAZY>(manager);
+        return ResidentBytes() - before;
+    }
+}
+
+TEST_CASE("Startup cost of eager and lazy construction", "[!benchmark]") {
+    // lazy first, so the eager run can not reuse pages it made resident
+    auto lazyBytes = ResidentGrowthOfRegistration<true>();
+    auto eagerBytes = ResidentGrowthOfRegistration<false>();
+    WARN("resident growth for " << SYNTHETIC_TYPES << " x 256KB types: eager " << (eagerBytes >> 10)
+         << " KB, lazy " << (lazyBytes >> 10) << " KB");
+
+    BENCHMARK("eager registration") {
+        DataManager manager;
+        RegisterSynthetic<false>(manager);
+        return manager.GetArena(LifeSpan::Global).Capacity();
+    };
+
+    BENCHMARK("lazy registration") {
+        DataManager manager;
+        RegisterSynthetic<true>(manager);
+        return manager.GetArena(LifeSpan::Global).Capacity();
+    };
+}
+
+//////////////////////////////////////////////////////////////////
+struct LockedVehicleState {
+    double speed{0.0};
+    double yawRate{0.0};
+    std::uint64_t stamp{0};
+};
+
+struct SeqVehicleState {
+    double speed{0.0};
+    double yawRate{0.0};
+    std::uint64_t stamp{0};
+};
+
+struct BenchStatePublisher {};
+struct BenchStateReader {};
+
+PERMISSION_REGISTER_FOR_CREATE_SYNC(BenchStatePublisher, Global, LockedVehicleState, 1);
+PERMISSION_REGISTER_FOR_CREATE_SYNC_OPT(BenchStatePublisher, Global, SeqVehicleState, 1, DataOption::SeqLock);
+PERMISSION_REGISTER_FOR_READ_SYNC(BenchStateReader, Global, LockedVehicleState);
+PERMISSION_REGISTER_FOR_READ_SYNC(BenchStateReader, Global, SeqVehicleState);
+
+namespace {
+    constexpr std::size_t STATE_READERS = 4;
+    constexpr std::size_t STATE_READS = 100000;
+    constexpr std::size_t STATE_WRITES = 10000;
+
+    // several threads read the state while one thread keeps publishing it
+    template<typename STATE>
+    std::uint64_t ReadWhilePublishing(DataContext& context) {
+        BenchStatePublisher publisher;
+        BenchStateReader reader;
+
+        std::vector<std::uint64_t> sums(STATE_READERS, 0);
+        std::vector<std::thread> readers;
+        for (std::size_t r = 0; r < STATE_READERS; r++) {
+            readers.emplace_back([&context, &reader, &sums, r] {
+                std::uint64_t sum = 0;
+                for (std::size_t i = 0; i < STATE_READS; i++) {
+                    sum += context.Fetch<STATE>(&reader)->stamp;
+                }
+                sums[r] = sum;
+            });
+        }
+        for (std::size_t i = 0; i < STATE_WRITES; i++) {
+            auto state = context.Fetch<STATE>(&publisher);
+            state->speed = double(i);
+            state->stamp = i;
+        }
+        for (auto& thread : readers) {
+            thread.join();
+        }
+
+        std::uint64_t total = 0;
+        for (auto sum : sums) {
+            total += sum;
+        }
+        return total;
+    }
+}
+
+TEST_CASE("Seqlock against reader-writer lock for small sync data", "[!benchmark]") {
+    auto& context = DataFramework::Instance().GetContext();
+
+    BENCHMARK("shared_timed_mutex") {
+        return ReadWhilePublishing<LockedVehicleState>(context);
+    };
+
+    BENCHMARK("seqlock") {
+        return ReadWhilePublishing<SeqVehicleState>(context);
+    };
+}
@@ -1,7 +1,15 @@
 #include "catch2/catch.hpp"
 #include "ads_dtf/dtf/data_framework.h"
 #include "ads_dtf/dtf/permission_register.h"
+#include "ads_dtf/dtf/bound_context.h"
+#include "ads_dtf/dtf/static_pipeline.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace ads_dtf;
 
@@ -138,3 +146,1596 @@ SCENARIO("Data Tree Framework Test") {
     REQUIRE(calcProcessor.Exec(context));
     REQUIRE(dlvrProcessor.Exec(context));
 }
+
+SCENARIO("Data slots are dense per lifespan") {
+    auto frameSlot = DataSlot<ProcessData, LifeSpan::Frame>::index;
+    auto cacheSlot = DataSlot<ProcessData, LifeSpan::Cache>::index;
+
+    REQUIRE(frameSlot < DataSlotCounter::Count(LifeSpan::Frame));
+    REQUIRE(cacheSlot < DataSlotCounter::Count(LifeSpan::Cache));
+    REQUIRE(frameSlot != DataSlot<FrameData, LifeSpan::Frame>::index);
+    REQUIRE(DataSlot<DeliveryData, LifeSpan::Global>::index == INVALID_SLOT);
+}
+
+//////////////////////////////////////////////////////////////////
+struct ArenaProbe {};
+
+PERMISSION_REGISTER_FOR_READ(ArenaProbe, Frame, FrameData);
+PERMISSION_REGISTER_FOR_READ(ArenaProbe, Frame, ProcessData);
+PERMISSION_REGISTER_FOR_READ(ArenaProbe, Frame, DeliveryData);
+
+SCENARIO("Data objects of one lifespan share one arena") {
+    auto& manager = DataFramework::Instance().GetManager();
+    auto& context = DataFramework::Instance().GetContext();
+
+    ArenaProbe probe;
+    FrameRecvProcessor recvProcessor;
+    CalcProcessor calcProcessor;
+
+    REQUIRE(recvProcessor.Exec(context));
+    REQUIRE(calcProcessor.Exec(context));
+
+    auto frame_data = context.Fetch<FrameData>(&probe);
+    auto process_data = context.Fetch<ProcessData>(&probe);
+    auto delivery_data = context.Fetch<DeliveryData>(&probe);
+
+    REQUIRE(frame_data);
+    REQUIRE(process_data);
+    REQUIRE(delivery_data);
+
+    const Arena& arena = manager.GetArena(LifeSpan::Frame);
+    REQUIRE(arena.Contains(frame_data.Get()));
+    REQUIRE(arena.Contains(process_data.Get()));
+    REQUIRE(arena.Contains(delivery_data.Get()));
+    REQUIRE(reinterpret_cast<std::uintptr_t>(arena.Data()) % CACHE_LINE_SIZE == 0);
+    REQUIRE_FALSE(manager.GetArena(LifeSpan::Cache).Contains(process_data.Get()));
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+}
+
+//////////////////////////////////////////////////////////////////
+struct LeftCounter {
+    std::uint64_t count{0};
+};
+
+void clear(LeftCounter& counter) {
+    counter.count = 0;
+}
+
+struct RightCounter {
+    std::uint64_t count{0};
+};
+
+struct LeftWriter {};
+struct RightWriter {};
+
+PERMISSION_REGISTER_FOR_CREATE_OPT(LeftWriter, Frame, LeftCounter, 1, DataOption::CacheLineIsolated);
+PERMISSION_REGISTER_FOR_CREATE_OPT(RightWriter, Frame, RightCounter, 1, DataOption::CacheLineIsolated);
+
+SCENARIO("Isolated data objects never share a cache line") {
+    auto& context = DataFramework::Instance().GetContext();
+
+    LeftWriter left;
+    RightWriter right;
+
+    auto left_counter = context.Create<LeftCounter>(&left);
+    auto right_counter = context.Create<RightCounter>(&right);
+
+    REQUIRE(left_counter);
+    REQUIRE(right_counter);
+
+    auto leftAddr = reinterpret_cast<std::uintptr_t>(left_counter.Get());
+    auto rightAddr = reinterpret_cast<std::uintptr_t>(right_counter.Get());
+
+    REQUIRE(leftAddr % CACHE_LINE_SIZE == 0);
+    REQUIRE(rightAddr % CACHE_LINE_SIZE == 0);
+    REQUIRE(leftAddr / CACHE_LINE_SIZE != rightAddr / CACHE_LINE_SIZE);
+}
+
+//////////////////////////////////////////////////////////////////
+struct CameraImage {
+    CameraImage(int camera) : camera(camera) {}
+    int camera{0};
+};
+
+struct CameraDriver {};
+struct CameraFusion {};
+
+PERMISSION_REGISTER_FOR_CREATE(CameraDriver, Frame, CameraImage, 3);
+PERMISSION_REGISTER_FOR_READ(CameraFusion, Frame, CameraImage);
+
+SCENARIO("Data type with capacity holds one instance per index") {
+    auto& context = DataFramework::Instance().GetContext();
+
+    CameraDriver driver;
+    CameraFusion fusion;
+
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(context.Create<CameraImage>(&driver, InstanceIndex(i), i + 10));
+    }
+    REQUIRE_FALSE(context.Create<CameraImage>(&driver, InstanceIndex(3), 13));
+
+    for (int i = 0; i < 3; i++) {
+        auto image = context.Fetch<CameraImage>(&fusion, InstanceIndex(i));
+        REQUIRE(image);
+        REQUIRE(image->camera == i + 10);
+    }
+    REQUIRE(context.Fetch<CameraImage>(&fusion)->camera == 10);
+    REQUIRE_FALSE(context.Fetch<CameraImage>(&fusion, InstanceIndex(3)));
+
+    context.Destroy<CameraImage>(&driver, InstanceIndex(1));
+    REQUIRE_FALSE(context.Fetch<CameraImage>(&fusion, InstanceIndex(1)));
+    REQUIRE(context.Fetch<CameraImage>(&fusion, InstanceIndex(2)));
+}
+
+//////////////////////////////////////////////////////////////////
+struct TrackResult {
+    TrackResult(std::uint64_t timestamp) : timestamp(timestamp) {}
+    std::uint64_t timestamp{0};
+};
+
+struct TrackProcessor {};
+struct TrackConsumer {};
+
+PERMISSION_REGISTER_FOR_CREATE_HISTORY(TrackProcessor, Frame, TrackResult, 1, 3);
+PERMISSION_REGISTER_FOR_READ(TrackConsumer, Frame, TrackResult);
+
+SCENARIO("History data keeps the last frames without copying") {
+    auto& context = DataFramework::Instance().GetContext();
+
+    TrackProcessor tracker;
+    TrackConsumer consumer;
+
+    const TrackResult* frames[4];
+    for (std::uint64_t ts = 100; ts <= 400; ts += 100) {
+        DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+        auto result = context.Create<TrackResult>(&tracker, ts);
+        REQUIRE(result);
+        frames[ts / 100 - 1] = result.Get();
+    }
+
+    auto history = context.History<TrackResult>(&consumer);
+    REQUIRE(history.Size() == 3);
+    REQUIRE(history[0]->timestamp == 400);
+    REQUIRE(history[1]->timestamp == 300);
+    REQUIRE(history[2]->timestamp == 200);
+    REQUIRE(history[1].Get() == frames[2]);
+    REQUIRE(frames[3] == frames[0]);
+    REQUIRE(context.Fetch<TrackResult>(&consumer)->timestamp == 400);
+
+    REQUIRE(history.Nearest(std::uint64_t(280))->timestamp == 300);
+    REQUIRE(history.Nearest(std::uint64_t(50))->timestamp == 200);
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+
+    REQUIRE_FALSE(context.Fetch<TrackResult>(&consumer));
+    auto rotated = context.History<TrackResult>(&consumer);
+    REQUIRE_FALSE(rotated[0]);
+    REQUIRE(rotated[1]->timestamp == 400);
+}
+
+struct LaneFit {
+    std::uint64_t timestamp{0};
+};
+
+struct LaneFitter {};
+
+PERMISSION_REGISTER_FOR_CREATE_HISTORY(LaneFitter, Frame, LaneFit, 1, 3);
+PERMISSION_REGISTER_FOR_READ(TrackConsumer, Frame, LaneFit);
+
+SCENARIO("A frame without Create has no current history entry") {
+    auto& context = DataFramework::Instance().GetContext();
+
+    LaneFitter fitter;
+    TrackConsumer consumer;
+
+    for (std::uint64_t ts = 100; ts <= 300; ts += 100) {
+        DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+        context.Create<LaneFit>(&fitter)->timestamp = ts;
+    }
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+
+    REQUIRE_FALSE(context.Fetch<LaneFit>(&consumer));
+    REQUIRE_FALSE(context.Fetch<LaneFit>(&fitter));
+    auto history = context.History<LaneFit>(&consumer);
+    REQUIRE_FALSE(history[0]);
+    REQUIRE(history[1]->timestamp == 300);
+    REQUIRE(history[2]->timestamp == 200);
+    REQUIRE(history.Nearest(std::uint64_t(0))->timestamp == 200);
+}
+
+SCENARIO("Reset only visits data written since the last reset") {
+    auto& manager = DataFramework::Instance().GetManager();
+    auto& context = DataFramework::Instance().GetContext();
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    auto pinned = manager.GetResetStats(LifeSpan::Frame).cleared;
+    auto total = pinned + manager.GetResetStats(LifeSpan::Frame).skipped;
+
+    LeftWriter left;
+    ArenaProbe probe;
+
+    REQUIRE(context.Create<LeftCounter>(&left));
+    REQUIRE(context.Fetch<DeliveryData>(&probe));
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    REQUIRE(manager.GetResetStats(LifeSpan::Frame).cleared == pinned + 1);
+    REQUIRE(manager.GetResetStats(LifeSpan::Frame).skipped == total - pinned - 1);
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    REQUIRE(manager.GetResetStats(LifeSpan::Frame).cleared == pinned);
+}
+
+//////////////////////////////////////////////////////////////////
+struct FrontAxleLoad {
+    int load{0};
+};
+
+void clear(FrontAxleLoad& axle) {
+    axle.load = 0;
+}
+
+struct RearAxleLoad {
+    int load{0};
+};
+
+void clear(RearAxleLoad& axle) {
+    axle.load = 0;
+}
+
+struct FrontAxleSensor {};
+struct RearAxleSensor {};
+
+PERMISSION_REGISTER_FOR_CREATE(FrontAxleSensor, Frame, FrontAxleLoad, 1);
+PERMISSION_REGISTER_FOR_CREATE(RearAxleSensor, Frame, RearAxleLoad, 1);
+
+SCENARIO("Writers on several threads never lose each other's dirty bits") {
+    auto& manager = DataFramework::Instance().GetManager();
+    auto& context = DataFramework::Instance().GetContext();
+
+    FrontAxleSensor front;
+    RearAxleSensor rear;
+    REQUIRE(context.Create<FrontAxleLoad>(&front));
+    REQUIRE(context.Create<RearAxleLoad>(&rear));
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    auto pinned = manager.GetResetStats(LifeSpan::Frame).cleared;
+
+    for (int frame = 1; frame <= 200; frame++) {
+        std::thread frontThread([&context, &front, frame] {
+            context.Fetch<FrontAxleLoad>(&front)->load = frame;
+        });
+        std::thread rearThread([&context, &rear, frame] {
+            context.Fetch<RearAxleLoad>(&rear)->load = frame;
+        });
+        frontThread.join();
+        rearThread.join();
+
+        DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+        REQUIRE(manager.GetResetStats(LifeSpan::Frame).cleared == pinned + 2);
+        REQUIRE(context.Fetch<FrontAxleLoad>(&front)->load == 0);
+        REQUIRE(context.Fetch<RearAxleLoad>(&rear)->load == 0);
+        DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    }
+}
+
+//////////////////////////////////////////////////////////////////
+struct ObstacleList {
+    std::vector<int> obstacles;
+};
+
+struct ObstacleDetector {};
+struct ObstacleTracker {};
+
+PERMISSION_REGISTER_FOR_CREATE_OPT(ObstacleDetector, Frame, ObstacleList, 1, DataOption::EpochReset | DataOption::Droppable);
+PERMISSION_REGISTER_FOR_READ(ObstacleTracker, Frame, ObstacleList);
+
+SCENARIO("Epoch reset data goes stale on reset without being visited") {
+    auto& manager = DataFramework::Instance().GetManager();
+    auto& context = DataFramework::Instance().GetContext();
+
+    ObstacleDetector detector;
+    ObstacleTracker tracker;
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    REQUIRE_FALSE(context.Fetch<ObstacleList>(&tracker));
+
+    auto obstacles = context.Create<ObstacleList>(&detector);
+    REQUIRE(obstacles);
+    obstacles->obstacles.push_back(1);
+    REQUIRE(context.Fetch<ObstacleList>(&tracker)->obstacles.size() == 1);
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    auto cleared = manager.GetResetStats(LifeSpan::Frame).cleared;
+
+    REQUIRE_FALSE(context.Fetch<ObstacleList>(&tracker));
+    REQUIRE_FALSE(context.Fetch<ObstacleList>(&detector));
+
+    REQUIRE(context.Create<ObstacleList>(&detector));
+    REQUIRE(context.Fetch<ObstacleList>(&tracker)->obstacles.empty());
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    REQUIRE(manager.GetResetStats(LifeSpan::Frame).cleared == cleared);
+}
+
+struct SonarEchoes {
+    void clear() {
+        clears++;
+    }
+
+    std::vector<int> echoes;
+    static inline int clears = 0;
+};
+
+struct SonarTracker {};
+struct SonarFusion {};
+
+PERMISSION_REGISTER_FOR_CREATE_SYNC_OPT(SonarTracker, Frame, SonarEchoes, 1, DataOption::EpochReset);
+PERMISSION_REGISTER_FOR_READ_SYNC(SonarFusion, Frame, SonarEchoes);
+
+SCENARIO("Sync epoch reset data is not visited by a reset either") {
+    auto& context = DataFramework::Instance().GetContext();
+
+    SonarTracker tracker;
+    SonarFusion fusion;
+
+    context.Create<SonarEchoes>(&tracker)->echoes.push_back(3);
+    REQUIRE(context.Fetch<SonarEchoes>(&fusion)->echoes.size() == 1);
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    REQUIRE_FALSE(context.Fetch<SonarEchoes>(&fusion));
+    REQUIRE(SonarEchoes::clears == 0);
+}
+
+//////////////////////////////////////////////////////////////////
+struct PointCloud {
+    PointCloud(std::size_t count) {
+        reset(count);
+    }
+
+    void reset(std::size_t count) {
+        points.assign(count, 0.0f);
+    }
+
+    void clear() {
+        points.clear();
+    }
+
+    std::vector<float> points;
+};
+
+struct LaneList {
+    void clear() {
+        lanes.clear();
+    }
+
+    std::vector<int> lanes;
+};
+
+struct LidarDriver {};
+struct LaneDetector {};
+
+PERMISSION_REGISTER_FOR_CREATE_OPT(LidarDriver, Frame, PointCloud, 1, DataOption::ReuseOnCreate);
+PERMISSION_REGISTER_FOR_CREATE_OPT(LaneDetector, Frame, LaneList, 1, DataOption::ReuseOnCreate | DataOption::EpochReset);
+
+SCENARIO("Reuse on create keeps the heap capacity of live data") {
+    auto& context = DataFramework::Instance().GetContext();
+
+    LidarDriver driver;
+    LaneDetector detector;
+
+    auto cloud = context.Create<PointCloud>(&driver, std::size_t(1000));
+    REQUIRE(cloud);
+    REQUIRE(cloud->points.size() == 1000);
+    const float* buffer = cloud->points.data();
+
+    auto lanes = context.Create<LaneList>(&detector);
+    lanes->lanes.assign(100, 1);
+    const int* laneBuffer = lanes->lanes.data();
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+
+    REQUIRE(context.Fetch<PointCloud>(&driver)->points.empty());
+    cloud = context.Create<PointCloud>(&driver, std::size_t(800));
+    REQUIRE(cloud->points.size() == 800);
+    REQUIRE(cloud->points.data() == buffer);
+
+    REQUIRE_FALSE(context.Fetch<LaneList>(&detector));
+    lanes = context.Create<LaneList>(&detector);
+    REQUIRE(lanes->lanes.empty());
+    REQUIRE(lanes->lanes.capacity() >= 100);
+    lanes->lanes.push_back(2);
+    REQUIRE(lanes->lanes.data() == laneBuffer);
+}
+
+//////////////////////////////////////////////////////////////////
+struct OccupancyGrid {
+    std::uint8_t cells[3 << 20];
+};
+
+struct LookupTable {
+    float values[1 << 16];
+};
+
+struct MapLoader {};
+struct GridPlanner {};
+
+PERMISSION_REGISTER_FOR_CREATE_OPT(MapLoader, Global, OccupancyGrid, 1, DataOption::HugePage);
+PERMISSION_REGISTER_FOR_CREATE_OPT(MapLoader, Global, LookupTable, 1, DataOption::MemoryLock);
+PERMISSION_REGISTER_FOR_READ(GridPlanner, Global, OccupancyGrid);
+
+SCENARIO("Large data is backed by its own prefaulted mapping") {
+    auto& manager = DataFramework::Instance().GetManager();
+    auto& context = DataFramework::Instance().GetContext();
+
+    GridPlanner planner;
+
+    auto grid = context.Fetch<OccupancyGrid>(&planner);
+    REQUIRE(grid);
+    REQUIRE(grid->cells[0] == 0);
+    REQUIRE_FALSE(manager.GetArena(LifeSpan::Global).Contains(grid.Get()));
+
+    auto report = manager.GetHugePageReport(LifeSpan::Global);
+    REQUIRE(report.mappedBytes >= sizeof(OccupancyGrid) + sizeof(LookupTable));
+    REQUIRE(report.hugePageBytes <= report.mappedBytes);
+    REQUIRE(report.lockedBytes <= report.mappedBytes);
+}
+
+//////////////////////////////////////////////////////////////////
+struct RadarTargets {
+    int count{0};
+};
+
+struct RadarDriver {};
+struct RadarFilter {};
+
+PERMISSION_REGISTER_FOR_CREATE(RadarDriver, Cache, RadarTargets, 2);
+PERMISSION_REGISTER_FOR_WRITE(RadarFilter, Cache, RadarTargets);
+
+SCENARIO("Data is moved onto the NUMA node of its creator") {
+    auto& manager = DataFramework::Instance().GetManager();
+    auto& context = DataFramework::Instance().GetContext();
+
+    RadarDriver driver;
+    RadarFilter filter;
+
+    REQUIRE(context.Create<RadarTargets>(&driver, InstanceIndex(1))->count == 0);
+    context.Fetch<RadarTargets>(&filter, InstanceIndex(1))->count = 7;
+    REQUIRE(manager.NumaNodeOf<RadarTargets, LifeSpan::Cache>() == NUMA_NODE_ANY);
+
+    manager.PlaceOnNodes(NumaNodeMap().Bind<RadarFilter>(0));
+    REQUIRE(manager.NumaNodeOf<RadarTargets, LifeSpan::Cache>() == 0);
+    REQUIRE(manager.NumaNodeOf<ProcessData, LifeSpan::Cache>() == NUMA_NODE_ANY);
+
+    auto targets = context.Fetch<RadarTargets>(&filter, InstanceIndex(1));
+    REQUIRE(targets->count == 7);
+    REQUIRE_FALSE(manager.GetArena(LifeSpan::Cache).Contains(targets.Get()));
+
+    manager.PlaceOnNodes(NumaNodeMap().Bind<RadarDriver>(0).Bind<RadarFilter>(numa_node_count()));
+    REQUIRE(manager.NumaNodeOf<RadarTargets, LifeSpan::Cache>() == 0);
+    REQUIRE(context.Fetch<RadarTargets>(&filter, InstanceIndex(1))->count == 7);
+}
+
+//////////////////////////////////////////////////////////////////
+struct WheelSpeed {
+    int ticks{0};
+};
+
+struct WheelOdometry {
+    int distance{0};
+};
+
+void clear(WheelOdometry& odometry) {
+    odometry.distance = 0;
+}
+
+struct ChassisDriver {};
+
+PERMISSION_REGISTER_FOR_CREATE(ChassisDriver, Frame, WheelSpeed, 1);
+PERMISSION_REGISTER_FOR_CREATE_OPT(ChassisDriver, Frame, WheelOdometry, 1, DataOption::Droppable);
+
+SCENARIO("Reset counts data without a clear method but only clears the rest") {
+    auto& manager = DataFramework::Instance().GetManager();
+    auto& context = DataFramework::Instance().GetContext();
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    auto pinned = manager.GetResetStats(LifeSpan::Frame).cleared;
+    auto total = pinned + manager.GetResetStats(LifeSpan::Frame).skipped;
+
+    ChassisDriver driver;
+    context.Create<WheelSpeed>(&driver)->ticks = 3;
+    context.Create<WheelOdometry>(&driver)->distance = 5;
+
+    // the written WheelSpeed has no clear method, it counts as skipped
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    REQUIRE(manager.GetResetStats(LifeSpan::Frame).cleared == pinned + 1);
+    REQUIRE(manager.GetResetStats(LifeSpan::Frame).skipped == total - pinned - 1);
+    REQUIRE(context.Fetch<WheelSpeed>(&driver)->ticks == 3);
+    REQUIRE(context.Fetch<WheelOdometry>(&driver)->distance == 0);
+}
+
+//////////////////////////////////////////////////////////////////
+struct MotionEstimator {};
+
+PERMISSION_REGISTER_FOR_READ(MotionEstimator, Frame, WheelSpeed);
+PERMISSION_REGISTER_FOR_READ(MotionEstimator, Frame, WheelOdometry);
+PERMISSION_REGISTER_FOR_READ(MotionEstimator, Frame, ObstacleList);
+
+SCENARIO("FetchAll gathers several data types in one call") {
+    auto& context = DataFramework::Instance().GetContext();
+
+    MotionEstimator estimator;
+    ObstacleDetector detector;
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+
+    auto inputs = context.FetchAll<WheelSpeed, WheelOdometry, ObstacleList>(&estimator);
+    REQUIRE_FALSE(all_present(inputs));
+
+    auto& [speed, odometry, obstacles] = inputs;
+    REQUIRE(speed.Get() == context.Fetch<WheelSpeed>(&estimator).Get());
+    REQUIRE(odometry.Get() == context.Fetch<WheelOdometry>(&estimator).Get());
+    REQUIRE_FALSE(obstacles);
+
+    context.Create<ObstacleList>(&detector);
+    REQUIRE(all_present(context.FetchAll<WheelSpeed, WheelOdometry, ObstacleList>(&estimator)));
+}
+
+//////////////////////////////////////////////////////////////////
+struct UnregisteredReader {};
+
+template<>
+struct ads_dtf::Permission<UnregisteredReader, WheelSpeed, ads_dtf::LifeSpan::Frame> {
+    constexpr static AccessMode mode = AccessMode::Read;
+    constexpr static bool sync = false;
+};
+
+SCENARIO("Access is checked against the registered permission matrix") {
+    GIVEN("an access controller with more columns than one matrix word") {
+        AccessController acl;
+        int user0 = 0, user1 = 0;
+
+        REQUIRE(acl.Register(&user0, 0, nullptr, LifeSpan::Frame, 3, AccessMode::Read));
+        REQUIRE(acl.Register(&user1, 1, nullptr, LifeSpan::Frame, 3, AccessMode::Create));
+        REQUIRE(acl.Register(&user1, 1, nullptr, LifeSpan::Frame, 70, AccessMode::Write));
+        REQUIRE(acl.Register(&user0, 0, nullptr, LifeSpan::Cache, 3, AccessMode::Write));
+        REQUIRE_FALSE(acl.Register(&user0, 0, nullptr, LifeSpan::Frame, 3, AccessMode::Write));
+
+        REQUIRE(acl.GetAccessModeAt(0, LifeSpan::Frame, 3) == AccessMode::Read);
+        REQUIRE(acl.GetAccessModeAt(1, LifeSpan::Frame, 3) == AccessMode::Create);
+        REQUIRE(acl.GetAccessModeAt(1, LifeSpan::Frame, 70) == AccessMode::Write);
+        REQUIRE(acl.GetAccessModeAt(0, LifeSpan::Cache, 3) == AccessMode::Write);
+        REQUIRE(acl.GetAccessModeAt(0, LifeSpan::Frame, 70) == AccessMode::None);
+        REQUIRE(acl.GetAccessModeAt(2, LifeSpan::Frame, 3) == AccessMode::None);
+        REQUIRE(acl.GetAccessMode(&user1, LifeSpan::Frame, 70) == AccessMode::Write);
+    }
+
+    WHEN("a user has the permission but never registered it") {
+        auto& context = DataFramework::Instance().GetContext();
+        UnregisteredReader reader;
+        ChassisDriver driver;
+
+        REQUIRE(context.Fetch<WheelSpeed>(&driver));
+        REQUIRE_FALSE(context.Fetch<WheelSpeed>(&reader));
+    }
+}
+
+//////////////////////////////////////////////////////////////////
+SCENARIO("A sealed manager keeps its layout and rejects registrations") {
+    DataManager manager;
+    DataContext context(manager);
+
+    REQUIRE(manager.Apply<ChassisDriver, WheelSpeed, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<ChassisDriver, WheelOdometry, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<ObstacleDetector, ObstacleList, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<MotionEstimator, WheelSpeed, LifeSpan::Frame>(AccessMode::Read));
+
+    ChassisDriver driver;
+    MotionEstimator estimator;
+    context.Create<WheelSpeed>(&driver)->ticks = 9;
+    auto capacity = manager.GetArena(LifeSpan::Frame).Capacity();
+
+    manager.Seal();
+    REQUIRE(manager.IsSealed());
+    REQUIRE(manager.GetArena(LifeSpan::Frame).Capacity() <= capacity);
+    REQUIRE(manager.GetArena(LifeSpan::Frame).Contains(context.Fetch<WheelSpeed>(&estimator).Get()));
+    REQUIRE(context.Fetch<WheelSpeed>(&estimator)->ticks == 9);
+
+    REQUIRE_FALSE(manager.Apply<MotionEstimator, WheelOdometry, LifeSpan::Frame>(AccessMode::Read));
+    REQUIRE_FALSE(manager.Apply<RadarDriver, RadarTargets, LifeSpan::Cache>(AccessMode::Create));
+    REQUIRE_FALSE(context.Fetch<WheelOdometry>(&estimator));
+}
+
+//////////////////////////////////////////////////////////////////
+struct SteerAngle {
+    int degrees{0};
+};
+
+struct SteerRate {
+    int rate{0};
+};
+
+void clear(SteerRate& rate) {
+    rate.rate = 0;
+}
+
+struct SteerLimits {
+    int max{0};
+};
+
+struct SteerSensor {};
+struct SteerController {};
+
+STATIC_PERMISSION_FOR_CREATE(SteerSensor, Frame, SteerAngle);
+STATIC_PERMISSION_FOR_CREATE(SteerSensor, Frame, SteerRate);
+STATIC_PERMISSION_FOR_CREATE(SteerController, Frame, SteerLimits);
+STATIC_PERMISSION_FOR_READ(SteerController, Frame, SteerAngle);
+STATIC_PERMISSION_FOR_WRITE(SteerController, Frame, SteerRate);
+
+using SteerPipeline = StaticPipeline<ProcessorList<SteerSensor, SteerController>,
+                                     DataList<SteerAngle, SteerRate, SteerLimits>>;
+
+SCENARIO("A static pipeline stores its data at fixed offsets") {
+    SteerPipeline pipeline;
+    SteerSensor sensor;
+    SteerController controller;
+
+    REQUIRE(pipeline.Create<SteerAngle>(&sensor, SteerAngle{4})->degrees == 4);
+    pipeline.Fetch<SteerRate>(&sensor)->rate = 12;
+    REQUIRE(pipeline.Fetch<SteerAngle>(&controller)->degrees == 4);
+    REQUIRE(pipeline.Fetch<SteerLimits>(&controller));
+
+    pipeline.ResetRepo(LifeSpan::Frame);
+    REQUIRE(pipeline.Fetch<SteerAngle>(&controller)->degrees == 4);
+    REQUIRE(pipeline.Fetch<SteerRate>(&controller)->rate == 0);
+
+    pipeline.Destroy<SteerAngle>(&sensor);
+    REQUIRE_FALSE(pipeline.Fetch<SteerAngle>(&controller));
+
+    SteerPipeline other;
+    auto offsetOf = [](SteerPipeline& owner, SteerController* user) {
+        return reinterpret_cast<const char*>(owner.Fetch<SteerRate>(user).Get()) - reinterpret_cast<const char*>(&owner);
+    };
+    REQUIRE(offsetOf(pipeline, &controller) == offsetOf(other, &controller));
+
+    // static only data never reaches the runtime registry
+    REQUIRE(DataSlot<SteerAngle, LifeSpan::Frame>::index == INVALID_SLOT);
+    REQUIRE(UserSlot<SteerSensor>::index == INVALID_SLOT);
+}
+
+//////////////////////////////////////////////////////////////////
+SCENARIO("A bound context resolves the data of a processor once") {
+    DataManager manager;
+    DataContext context(manager);
+
+    REQUIRE(manager.Apply<ChassisDriver, WheelSpeed, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<ChassisDriver, WheelOdometry, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<MotionEstimator, WheelSpeed, LifeSpan::Frame>(AccessMode::Read));
+    REQUIRE(manager.Apply<MotionEstimator, WheelOdometry, LifeSpan::Frame>(AccessMode::Read));
+
+    using DriverContext = BoundContext<ChassisDriver, WheelSpeed, WheelOdometry>;
+    using EstimatorContext = BoundContext<MotionEstimator, WheelSpeed, WheelOdometry>;
+
+    REQUIRE_FALSE(EstimatorContext(manager).IsBound());
+
+    manager.Seal();
+    DriverContext driver(manager);
+    EstimatorContext estimator(manager);
+    REQUIRE(driver.IsBound());
+    REQUIRE(estimator.IsBound());
+
+    static_assert(std::is_same<decltype(driver.Fetch<WheelSpeed>()), OptionalPtr<WheelSpeed, SyncMode::None>>::value, "");
+    static_assert(std::is_same<decltype(estimator.Fetch<WheelSpeed>()), OptionalPtr<const WheelSpeed, SyncMode::None>>::value, "");
+
+    ChassisDriver chassis;
+    driver.Fetch<WheelSpeed>()->ticks = 6;
+    REQUIRE(estimator.Fetch<WheelSpeed>()->ticks == 6);
+    REQUIRE(estimator.Fetch<WheelSpeed>().Get() == context.Fetch<WheelSpeed>(&chassis).Get());
+
+    context.Destroy<WheelOdometry>(&chassis);
+    REQUIRE_FALSE(estimator.Fetch<WheelOdometry>());
+    context.Create<WheelOdometry>(&chassis)->distance = 2;
+    REQUIRE(estimator.Fetch<WheelOdometry>()->distance == 2);
+}
+
+//////////////////////////////////////////////////////////////////
+struct CalibrationTable {
+    CalibrationTable() {
+        constructions++;
+    }
+    static inline int constructions = 0;
+    int version{1};
+};
+
+struct CalibrationLoader {};
+struct CalibrationUser {};
+
+PERMISSION_REGISTER_FOR_CREATE_OPT(CalibrationLoader, Global, CalibrationTable, 2, DataOption::Lazy);
+PERMISSION_REGISTER_FOR_READ(CalibrationUser, Global, CalibrationTable);
+
+SCENARIO("Lazy data is constructed on its first use") {
+    auto& context = DataFramework::Instance().GetContext();
+    CalibrationUser user;
+
+    REQUIRE(CalibrationTable::constructions == 0);
+    DataFramework::Instance().ResetRepo(LifeSpan::Global);
+    REQUIRE(CalibrationTable::constructions == 0);
+
+    REQUIRE(context.Fetch<CalibrationTable>(&user, InstanceIndex(1))->version == 1);
+    REQUIRE(CalibrationTable::constructions == 2);
+
+    REQUIRE(context.Fetch<CalibrationTable>(&user)->version == 1);
+    REQUIRE(CalibrationTable::constructions == 2);
+}
+
+// a creator by its compile time permission that no manager registers
+struct CalibrationIntruder {};
+
+template<>
+struct ads_dtf::Permission<CalibrationIntruder, CalibrationTable, LifeSpan::Global> {
+    constexpr static AccessMode mode = AccessMode::Create;
+    constexpr static bool sync = false;
+};
+
+SCENARIO("A refused access never constructs lazy data") {
+    DataManager manager;
+    DataContext context(manager);
+    REQUIRE(manager.Apply<CalibrationLoader, CalibrationTable, LifeSpan::Global>(AccessMode::Create));
+    int constructions = CalibrationTable::constructions;
+
+    CalibrationIntruder intruder;
+    context.Destroy<CalibrationTable>(&intruder);
+    REQUIRE_FALSE(context.Create<CalibrationTable>(&intruder));
+    REQUIRE(CalibrationTable::constructions == constructions);
+
+    CalibrationLoader loader;
+    context.Destroy<CalibrationTable>(&loader);
+    REQUIRE(CalibrationTable::constructions == constructions + 2);
+}
+
+//////////////////////////////////////////////////////////////////
+SCENARIO("Sealing drops data nobody consumes") {
+    DataManager manager;
+    DataContext context(manager);
+
+    REQUIRE(manager.Apply<ChassisDriver, WheelSpeed, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<ChassisDriver, WheelOdometry, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<ObstacleDetector, ObstacleList, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<MotionEstimator, WheelSpeed, LifeSpan::Frame>(AccessMode::Read));
+    REQUIRE(manager.Apply<CalibrationUser, CalibrationTable, LifeSpan::Global>(AccessMode::Read));
+
+    ChassisDriver driver;
+    MotionEstimator estimator;
+    ObstacleDetector detector;
+    context.Create<WheelSpeed>(&driver)->ticks = 11;
+    auto capacity = manager.GetArena(LifeSpan::Frame).Capacity();
+
+    manager.Seal();
+    REQUIRE(manager.GetArena(LifeSpan::Frame).Capacity() < capacity);
+    REQUIRE(context.Fetch<WheelSpeed>(&estimator)->ticks == 11);
+    REQUIRE(manager.GetArena(LifeSpan::Frame).Contains(context.Fetch<WheelSpeed>(&estimator).Get()));
+
+    REQUIRE_FALSE(context.Create<WheelOdometry>(&driver));
+    REQUIRE_FALSE(context.Fetch<ObstacleList>(&detector));
+}
+
+SCENARIO("Sealing keeps data its creator reads back") {
+    DataManager manager;
+    DataContext context(manager);
+
+    REQUIRE(manager.Apply<FrameRecvProcessor, FrameData, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<CalcProcessor, ProcessData, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<CalcProcessor, ProcessData, LifeSpan::Cache>(AccessMode::Create));
+    REQUIRE(manager.Apply<CalcProcessor, FrameData, LifeSpan::Frame>(AccessMode::Read));
+    REQUIRE(manager.Apply<DeliveryProcessor, DeliveryData, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<DeliveryProcessor, FrameData, LifeSpan::Frame>(AccessMode::Write));
+    REQUIRE(manager.Apply<DeliveryProcessor, ProcessData, LifeSpan::Frame>(AccessMode::Read));
+    REQUIRE(manager.Apply<DeliveryProcessor, ProcessData, LifeSpan::Cache>(AccessMode::Read));
+    manager.Seal();
+
+    FrameRecvProcessor recvProcessor;
+    CalcProcessor calcProcessor;
+    DeliveryProcessor dlvrProcessor;
+
+    REQUIRE(recvProcessor.Exec(context));
+    REQUIRE(calcProcessor.Exec(context));
+    REQUIRE(dlvrProcessor.Exec(context));
+    REQUIRE(context.Fetch<DeliveryData>(&dlvrProcessor)->result > 0);
+}
+
+//////////////////////////////////////////////////////////////////
+struct RawScan {
+    std::vector<float> points;
+};
+
+struct FilteredScan {
+    std::vector<float> points;
+};
+
+struct ScanClusters {
+    std::vector<int> sizes;
+};
+
+struct ScanDriver {};
+struct ScanFilter {};
+struct ScanClusterer {};
+struct ScanTracker {};
+
+PERMISSION_REGISTER_FOR_CREATE(ScanDriver, Frame, RawScan, 1);
+PERMISSION_REGISTER_FOR_READ(ScanFilter, Frame, RawScan);
+PERMISSION_REGISTER_FOR_CREATE(ScanFilter, Frame, FilteredScan, 1);
+PERMISSION_REGISTER_FOR_READ(ScanClusterer, Frame, FilteredScan);
+PERMISSION_REGISTER_FOR_CREATE(ScanClusterer, Frame, ScanClusters, 1);
+PERMISSION_REGISTER_FOR_READ(ScanTracker, Frame, ScanClusters);
+
+namespace {
+    void RegisterScanPipeline(DataManager& manager) {
+        manager.Apply<ScanDriver, RawScan, LifeSpan::Frame>(AccessMode::Create);
+        manager.Apply<ScanFilter, RawScan, LifeSpan::Frame>(AccessMode::Read);
+        manager.Apply<ScanFilter, FilteredScan, LifeSpan::Frame>(AccessMode::Create);
+        manager.Apply<ScanClusterer, FilteredScan, LifeSpan::Frame>(AccessMode::Read);
+        manager.Apply<ScanClusterer, ScanClusters, LifeSpan::Frame>(AccessMode::Create);
+        manager.Apply<ScanTracker, ScanClusters, LifeSpan::Frame>(AccessMode::Read);
+    }
+}
+
+SCENARIO("Frame data with disjoint live intervals shares arena bytes") {
+    DataManager unshared;
+    RegisterScanPipeline(unshared);
+    unshared.Seal();
+
+    DataManager manager;
+    DataContext context(manager);
+    RegisterScanPipeline(manager);
+    manager.Seal(ProcessorOrder().Then<ScanDriver>().Then<ScanFilter>().Then<ScanClusterer>().Then<ScanTracker>());
+
+    REQUIRE(manager.GetArena(LifeSpan::Frame).Capacity() < unshared.GetArena(LifeSpan::Frame).Capacity());
+
+    ScanDriver driver;
+    ScanFilter filter;
+    ScanClusterer clusterer;
+    ScanTracker tracker;
+
+    auto raw = context.Create<RawScan>(&driver);
+    raw->points = {1.0f, 2.0f, 3.0f};
+    REQUIRE(context.Fetch<RawScan>(&filter)->points.size() == 3);
+
+    context.Create<FilteredScan>(&filter)->points = context.Fetch<RawScan>(&filter)->points;
+    REQUIRE(context.Fetch<FilteredScan>(&clusterer)->points.size() == 3);
+
+    auto clusters = context.Create<ScanClusters>(&clusterer);
+    clusters->sizes = {2, 1};
+    REQUIRE(static_cast<void*>(clusters.Get()) == static_cast<void*>(raw.Get()));
+    REQUIRE(context.Fetch<ScanClusters>(&tracker)->sizes.size() == 2);
+    REQUIRE(context.Fetch<FilteredScan>(&clusterer)->points.size() == 3);
+
+    // the overwritten data is gone until it is created again, fetching never takes the bytes back
+    REQUIRE_FALSE(context.Fetch<RawScan>(&filter));
+    REQUIRE(context.Fetch<ScanClusters>(&tracker)->sizes.size() == 2);
+
+    // a bound context follows the owner of the bytes the same way
+    BoundContext<ScanFilter, RawScan, FilteredScan> bound(manager);
+    REQUIRE(bound.IsBound());
+    REQUIRE_FALSE(bound.Fetch<RawScan>());
+    REQUIRE(bound.Fetch<FilteredScan>()->points.size() == 3);
+
+    REQUIRE(context.Create<RawScan>(&driver)->points.empty());
+    REQUIRE_FALSE(context.Fetch<ScanClusters>(&tracker));
+    REQUIRE(bound.Fetch<RawScan>()->points.empty());
+}
+
+//////////////////////////////////////////////////////////////////
+struct CostMap {
+    std::uint64_t cells[16];
+};
+
+struct CostSummary {
+    int occupied{0};
+};
+
+struct CostMapBuilder {};
+struct CostMapReader {};
+struct CostSummaryBuilder {};
+struct CostSummaryReader {};
+
+PERMISSION_REGISTER_FOR_CREATE(CostMapBuilder, Frame, CostMap, 1);
+PERMISSION_REGISTER_FOR_READ(CostMapReader, Frame, CostMap);
+PERMISSION_REGISTER_FOR_CREATE(CostSummaryBuilder, Frame, CostSummary, 1);
+PERMISSION_REGISTER_FOR_READ(CostSummaryReader, Frame, CostSummary);
+
+SCENARIO("A bound context may be built while other data owns the shared bytes") {
+    DataManager manager;
+    DataContext context(manager);
+    REQUIRE(manager.Apply<CostMapBuilder, CostMap, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<CostMapReader, CostMap, LifeSpan::Frame>(AccessMode::Read));
+    REQUIRE(manager.Apply<CostSummaryBuilder, CostSummary, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<CostSummaryReader, CostSummary, LifeSpan::Frame>(AccessMode::Read));
+    manager.Seal(ProcessorOrder().Then<CostMapBuilder>().Then<CostMapReader>().Then<CostSummaryBuilder>().Then<CostSummaryReader>());
+
+    CostMapBuilder mapBuilder;
+    CostSummaryBuilder summaryBuilder;
+
+    // the map owns the bytes of the summary and fills them while the reader binds
+    auto map = context.Create<CostMap>(&mapBuilder);
+    std::fill(std::begin(map->cells), std::end(map->cells), 0xabababababababab);
+    BoundContext<CostSummaryReader, CostSummary> reader(manager);
+    REQUIRE(reader.IsBound());
+    REQUIRE_FALSE(reader.Fetch<CostSummary>());
+
+    context.Create<CostSummary>(&summaryBuilder)->occupied = 7;
+    REQUIRE(reader.Fetch<CostSummary>()->occupied == 7);
+}
+
+//////////////////////////////////////////////////////////////////
+SCENARIO("Seal plans the exact footprint of every span") {
+    DataManager manager;
+    REQUIRE(manager.Apply<CameraDriver, CameraImage, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<CameraFusion, CameraImage, LifeSpan::Frame>(AccessMode::Read));
+    REQUIRE(manager.Apply<TrackProcessor, TrackResult, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<TrackConsumer, TrackResult, LifeSpan::Frame>(AccessMode::Read));
+    REQUIRE(manager.Apply<RadarDriver, RadarTargets, LifeSpan::Cache>(AccessMode::Create));
+    REQUIRE(manager.Apply<RadarFilter, RadarTargets, LifeSpan::Cache>(AccessMode::Write));
+    REQUIRE(manager.GetMemoryPlan().TotalBytes() == 0);
+
+    manager.Seal();
+    auto& frame = manager.GetMemoryPlan().Of(LifeSpan::Frame);
+    REQUIRE(frame.entries.size() == 2);
+    REQUIRE(frame.arenaBytes == manager.GetArena(LifeSpan::Frame).Capacity());
+    REQUIRE(frame.dataBytes == 3 * sizeof(CameraImage) + 3 * sizeof(TrackResult));
+
+    auto& image = frame.entries[0].name == "CameraImage" ? frame.entries[0] : frame.entries[1];
+    auto& track = frame.entries[0].name == "TrackResult" ? frame.entries[0] : frame.entries[1];
+    REQUIRE(image.name == "CameraImage");
+    REQUIRE(track.name == "TrackResult");
+    REQUIRE(image.size == sizeof(CameraImage));
+    REQUIRE(image.align == alignof(CameraImage));
+    REQUIRE(image.capacity == 3);
+    REQUIRE(track.history == 3);
+    REQUIRE(image.bookkeeping >= 3 * (sizeof(bool) + sizeof(std::uint32_t)));
+    REQUIRE(image.padding < (3 + 1) * image.objectAlign);
+    REQUIRE(image.bookkeeping + image.padding == image.objectSize - 3 * sizeof(CameraImage));
+
+    // packed back to back, with no more than alignment gaps
+    auto& first = image.offset < track.offset ? image : track;
+    auto& second = image.offset < track.offset ? track : image;
+    REQUIRE(first.offset == 0);
+    REQUIRE(second.offset == align_up(first.objectSize, second.objectAlign));
+    REQUIRE(frame.arenaBytes == second.offset + second.objectSize);
+
+    auto& cache = manager.GetMemoryPlan().Of(LifeSpan::Cache);
+    REQUIRE(cache.entries.size() == 1);
+    REQUIRE(cache.entries[0].capacity == 2);
+    REQUIRE(manager.GetMemoryPlan().TotalBytes() == frame.arenaBytes + cache.arenaBytes);
+
+    std::ostringstream json;
+    manager.GetMemoryPlan().WriteJson(json);
+    REQUIRE(json.str().find("\"name\":\"CameraImage\",\"slot\":") != std::string::npos);
+    REQUIRE(json.str().find("\"span\":\"Cache\",\"total_bytes\":" + std::to_string(cache.arenaBytes)) != std::string::npos);
+    REQUIRE(json.str().find("\"bookkeeping\":" + std::to_string(image.bookkeeping) + ",\"padding\":" + std::to_string(image.padding)) != std::string::npos);
+}
+
+//////////////////////////////////////////////////////////////////
+SCENARIO("Type names keep their array bounds and template arguments") {
+    REQUIRE(TypeNameOf<CameraImage>() == "CameraImage");
+    REQUIRE(TypeNameOf<float[4]>().find("[4]") != std::string_view::npos);
+    REQUIRE(TypeNameOf<Mailbox<float[4]>>().back() == '>');
+}
+
+//////////////////////////////////////////////////////////////////
+struct TrafficLightState {
+    int changes{0};
+    int mirror{0};
+};
+
+struct TrafficLightDetector {};
+struct TrafficLightFilter {};
+struct TrafficLightPlanner {};
+
+PERMISSION_REGISTER_FOR_CREATE_SYNC(TrafficLightDetector, Cache, TrafficLightState, 1);
+PERMISSION_REGISTER_FOR_WRITE_SYNC(TrafficLightFilter, Cache, TrafficLightState);
+PERMISSION_REGISTER_FOR_READ_SYNC(TrafficLightPlanner, Cache, TrafficLightState);
+
+SCENARIO("Sync data is shared by processors on several threads") {
+    auto& context = DataFramework::Instance().GetContext();
+    TrafficLightDetector detector;
+    TrafficLightFilter filter;
+    TrafficLightPlanner planner;
+
+    REQUIRE(context.Create<TrafficLightState>(&detector));
+
+    constexpr int UPDATES = 2000;
+    auto write = [&context](auto* user) {
+        for (int i = 0; i < UPDATES; i++) {
+            auto state = context.Fetch<TrafficLightState>(user);
+            state->changes++;
+            state->mirror = state->changes;
+        }
+    };
+
+    bool torn = false;
+    std::thread detectorThread(write, &detector);
+    std::thread filterThread(write, &filter);
+    std::thread plannerThread([&context, &planner, &torn] {
+        for (int i = 0; i < UPDATES; i++) {
+            auto state = context.Fetch<TrafficLightState>(&planner);
+            torn = torn || (state->changes != state->mirror);
+        }
+    });
+    detectorThread.join();
+    filterThread.join();
+    plannerThread.join();
+
+    REQUIRE_FALSE(torn);
+    REQUIRE(context.Fetch<TrafficLightState>(&planner)->changes == 2 * UPDATES);
+
+    // the reader lock is released with the pointer, so Create can take the cell
+    {
+        auto state = context.Fetch<TrafficLightState>(&planner);
+        REQUIRE(state);
+    }
+    REQUIRE(context.Create<TrafficLightState>(&detector)->changes == 0);
+    context.Destroy<TrafficLightState>(&detector);
+    REQUIRE_FALSE(context.Fetch<TrafficLightState>(&planner));
+}
+
+//////////////////////////////////////////////////////////////////
+struct EgoPose {
+    double x{0.0};
+    double y{0.0};
+    std::uint64_t stamp{0};
+};
+
+struct PoseEstimator {};
+struct PoseFuser {};
+struct PoseConsumer {};
+
+PERMISSION_REGISTER_FOR_CREATE_SYNC_OPT(PoseEstimator, Global, EgoPose, 1, DataOption::SeqLock);
+PERMISSION_REGISTER_FOR_WRITE_SYNC(PoseFuser, Global, EgoPose);
+PERMISSION_REGISTER_FOR_READ_SYNC(PoseConsumer, Global, EgoPose);
+
+SCENARIO("Seqlock data is read as a copy without blocking its writer") {
+    auto& context = DataFramework::Instance().GetContext();
+    PoseEstimator estimator;
+    PoseFuser fuser;
+    PoseConsumer consumer;
+
+    REQUIRE(context.Create<EgoPose>(&estimator, EgoPose{1.0, 2.0, 1}));
+
+    // a write is published when its pointer is released, a copy never changes
+    auto before = context.Fetch<EgoPose>(&consumer);
+    {
+        auto pose = context.Fetch<EgoPose>(&fuser);
+        *pose = EgoPose{2.0, 4.0, 2};
+        REQUIRE(context.Fetch<EgoPose>(&consumer)->stamp == 1);
+    }
+    REQUIRE(before->stamp == 1);
+    REQUIRE(context.Fetch<EgoPose>(&consumer)->stamp == 2);
+
+    constexpr std::uint64_t UPDATES = 5000;
+    std::thread writer([&context, &fuser] {
+        for (std::uint64_t i = 1; i <= UPDATES; i++) {
+            auto pose = context.Fetch<EgoPose>(&fuser);
+            pose->x = double(i);
+            pose->y = double(2 * i);
+            pose->stamp = i;
+        }
+    });
+
+    bool torn = false;
+    std::thread reader([&context, &consumer, &torn] {
+        for (std::uint64_t i = 0; i < UPDATES; i++) {
+            auto pose = context.Fetch<EgoPose>(&consumer);
+            torn = torn || (pose->y != 2 * pose->x) || (pose->stamp != std::uint64_t(pose->x));
+        }
+    });
+    writer.join();
+    reader.join();
+
+    REQUIRE_FALSE(torn);
+    REQUIRE(context.Fetch<EgoPose>(&consumer)->stamp == UPDATES);
+
+    context.Destroy<EgoPose>(&estimator);
+    REQUIRE_FALSE(context.Fetch<EgoPose>(&consumer));
+    REQUIRE_FALSE(context.Fetch<EgoPose>(&fuser));
+}
+
+//////////////////////////////////////////////////////////////////
+struct RoadNetwork {
+    RoadNetwork() {
+        instances++;
+    }
+
+    RoadNetwork(const RoadNetwork& other) : lanes(other.lanes), revision(other.revision) {
+        instances++;
+    }
+
+    ~RoadNetwork() {
+        instances--;
+    }
+
+    std::vector<int> lanes;
+    int revision{0};
+    static int instances;
+};
+
+int RoadNetwork::instances = 0;
+
+struct MapServer {};
+struct MapPatcher {};
+struct RoutePlanner {};
+
+PERMISSION_REGISTER_FOR_CREATE_SYNC_OPT(MapServer, Global, RoadNetwork, 1, DataOption::Rcu);
+PERMISSION_REGISTER_FOR_WRITE_SYNC(MapPatcher, Global, RoadNetwork);
+PERMISSION_REGISTER_FOR_READ_SYNC(RoutePlanner, Global, RoadNetwork);
+
+SCENARIO("RCU data is published by a pointer swap and reclaimed at the frame boundary") {
+    auto& manager = DataFramework::Instance().GetManager();
+    auto& context = DataFramework::Instance().GetContext();
+    MapServer server;
+    MapPatcher patcher;
+    RoutePlanner planner;
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    REQUIRE(RoadNetwork::instances == 1);
+
+    // readers keep the version they pinned while a new one is built and published
+    {
+        auto pinned = context.Fetch<RoadNetwork>(&planner);
+        REQUIRE(pinned->revision == 0);
+        {
+            auto network = context.Fetch<RoadNetwork>(&patcher);
+            network->lanes.push_back(1);
+            network->revision = 1;
+            REQUIRE(context.Fetch<RoadNetwork>(&planner)->revision == 0);
+        }
+        REQUIRE(context.Fetch<RoadNetwork>(&planner)->revision == 1);
+        REQUIRE(pinned->revision == 0);
+    }
+    REQUIRE(manager.GetRetiredVersions() == 1);
+    REQUIRE(RoadNetwork::instances == 2);
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    REQUIRE(manager.GetRetiredVersions() == 0);
+    REQUIRE(RoadNetwork::instances == 1);
+
+    constexpr int REVISIONS = 500;
+    std::thread writer([&context, &patcher] {
+        for (int i = 0; i < REVISIONS; i++) {
+            auto network = context.Fetch<RoadNetwork>(&patcher);
+            network->lanes.push_back(network->revision);
+            network->revision++;
+        }
+    });
+
+    bool torn = false;
+    std::thread reader([&context, &planner, &torn] {
+        for (int i = 0; i < REVISIONS; i++) {
+            auto network = context.Fetch<RoadNetwork>(&planner);
+            torn = torn || (int(network->lanes.size()) != network->revision);
+        }
+    });
+    writer.join();
+    reader.join();
+
+    REQUIRE_FALSE(torn);
+    REQUIRE(context.Fetch<RoadNetwork>(&planner)->revision == REVISIONS + 1);
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    REQUIRE(RoadNetwork::instances == 1);
+
+    REQUIRE(context.Create<RoadNetwork>(&server)->revision == 0);
+    context.Destroy<RoadNetwork>(&server);
+    REQUIRE_FALSE(context.Fetch<RoadNetwork>(&planner));
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    REQUIRE(RoadNetwork::instances == 0);
+
+    REQUIRE(context.Create<RoadNetwork>(&server));
+}
+
+SCENARIO("An RCU reader keeps its version across the frame boundary") {
+    auto& manager = DataFramework::Instance().GetManager();
+    auto& context = DataFramework::Instance().GetContext();
+    MapPatcher patcher;
+    RoutePlanner planner;
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    {
+        auto pinned = context.Fetch<RoadNetwork>(&planner);
+        int revision = pinned->revision;
+        context.Fetch<RoadNetwork>(&patcher)->revision = revision + 1;
+
+        DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+        REQUIRE(manager.GetRetiredVersions() == 1);
+        REQUIRE(pinned->revision == revision);
+        REQUIRE(context.Fetch<RoadNetwork>(&planner)->revision == revision + 1);
+    }
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    REQUIRE(manager.GetRetiredVersions() == 0);
+}
+
+SCENARIO("RCU reclamation makes progress while readers keep reading") {
+    auto& manager = DataFramework::Instance().GetManager();
+    auto& context = DataFramework::Instance().GetContext();
+    MapPatcher patcher;
+    RoutePlanner planner;
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    REQUIRE(manager.GetRetiredVersions() == 0);
+
+    // some reader is reading at every frame boundary, each one pins only the
+    // versions published since it started
+    {
+        auto held = context.Fetch<RoadNetwork>(&planner);
+        for (int frame = 0; frame < 8; frame++) {
+            context.Fetch<RoadNetwork>(&patcher)->revision++;
+            auto next = context.Fetch<RoadNetwork>(&planner);
+            held = std::move(next);
+            DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+            REQUIRE(manager.GetRetiredVersions() <= 1);
+        }
+    }
+
+    // the same with a reader thread that never lets go of a version, each
+    // frame waits until it read twice since the publish
+    std::atomic<bool> done{false};
+    std::atomic<int> reads{0};
+    std::thread reader([&context, &planner, &done, &reads] {
+        auto held = context.Fetch<RoadNetwork>(&planner);
+        while (!done.load()) {
+            auto next = context.Fetch<RoadNetwork>(&planner);
+            held = std::move(next);
+            reads++;
+        }
+    });
+    std::size_t mostRetired = 0;
+    for (int frame = 0; frame < 200; frame++) {
+        context.Fetch<RoadNetwork>(&patcher)->revision++;
+        int published = reads.load();
+        while (reads.load() < published + 2) {
+            std::this_thread::yield();
+        }
+        DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+        mostRetired = std::max(mostRetired, manager.GetRetiredVersions());
+    }
+    done = true;
+    reader.join();
+    REQUIRE(mostRetired <= 2);
+
+    DataFramework::Instance().ResetRepo(LifeSpan::Frame);
+    REQUIRE(manager.GetRetiredVersions() == 0);
+}
+
+SCENARIO("RCU versions take no bytes in the span arena") {
+    DataManager manager;
+    REQUIRE(manager.Apply<MapServer, RoadNetwork, LifeSpan::Global>(AccessMode::Create));
+    REQUIRE(manager.Apply<RoutePlanner, RoadNetwork, LifeSpan::Global>(AccessMode::Read));
+    manager.Seal();
+
+    auto& plan = manager.GetMemoryPlan().Of(LifeSpan::Global);
+    REQUIRE(plan.entries.size() == 1);
+    REQUIRE(plan.dataBytes == 0);
+    REQUIRE(plan.entries[0].bookkeeping + plan.entries[0].padding == plan.entries[0].objectSize);
+}
+
+//////////////////////////////////////////////////////////////////
+struct ImuSample {
+    std::uint64_t sequence{0};
+    std::uint64_t checksum{0};
+    std::vector<float> readings;
+};
+
+struct ImuDriver {};
+struct ImuFrameRecv {};
+
+PERMISSION_REGISTER_FOR_CREATE(ImuFrameRecv, Cache, Mailbox<ImuSample>, 1);
+PERMISSION_REGISTER_FOR_WRITE(ImuDriver, Cache, Mailbox<ImuSample>);
+
+SCENARIO("A mailbox hands the newest value from a driver thread to the frame") {
+    auto& context = DataFramework::Instance().GetContext();
+    ImuDriver driver;
+    ImuFrameRecv recv;
+
+    auto mailbox = context.Fetch<Mailbox<ImuSample>>(&recv);
+    REQUIRE(mailbox);
+    REQUIRE_FALSE(mailbox->Take());
+
+    // values posted between two frames are dropped, only the newest one is taken
+    context.Fetch<Mailbox<ImuSample>>(&driver)->Post(ImuSample{1, 1, {}});
+    context.Fetch<Mailbox<ImuSample>>(&driver)->Post(ImuSample{2, 2, {}});
+    auto sample = mailbox->Take();
+    REQUIRE(sample->sequence == 2);
+    REQUIRE_FALSE(mailbox->Take());
+
+    constexpr std::uint64_t SAMPLES = 20000;
+    std::thread driverThread([&context, &driver] {
+        for (std::uint64_t i = 3; i <= SAMPLES; i++) {
+            context.Fetch<Mailbox<ImuSample>>(&driver)->Write([i](ImuSample& back) {
+                back.sequence = i;
+                back.readings.assign(4, float(i));
+                back.checksum = i * 4;
+            });
+        }
+    });
+
+    std::uint64_t last = 2;
+    bool ordered = true;
+    while (last < SAMPLES) {
+        auto newest = mailbox->Take();
+        if (!newest) {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered = ordered && (newest->sequence > last) && (newest->checksum == newest->readings.size() * newest->sequence);
+        last = newest->sequence;
+    }
+    driverThread.join();
+    REQUIRE(ordered);
+}
+
+struct ImuMonitor {};
+
+PERMISSION_REGISTER_FOR_READ(ImuMonitor, Cache, Mailbox<ImuSample>);
+
+SCENARIO("A mailbox reader takes through a consumer and Create keeps the mailbox") {
+    DataManager manager;
+    DataContext context(manager);
+    REQUIRE(manager.Apply<ImuFrameRecv, Mailbox<ImuSample>, LifeSpan::Cache>(AccessMode::Create));
+    REQUIRE(manager.Apply<ImuDriver, Mailbox<ImuSample>, LifeSpan::Cache>(AccessMode::Write));
+    REQUIRE(manager.Apply<ImuMonitor, Mailbox<ImuSample>, LifeSpan::Cache>(AccessMode::Read));
+
+    ImuDriver driver;
+    ImuFrameRecv recv;
+    ImuMonitor monitor;
+
+    context.Fetch<Mailbox<ImuSample>>(&driver)->Post(ImuSample{7, 7, {}});
+    auto mailbox = context.Create<Mailbox<ImuSample>>(&recv);
+    REQUIRE(mailbox.Get() == context.Fetch<Mailbox<ImuSample>>(&driver).Get());
+
+    Mailbox<ImuSample>::Consumer input = context.Fetch<Mailbox<ImuSample>>(&monitor);
+    REQUIRE(input.HasNews());
+    REQUIRE(input.Take()->sequence == 7);
+    REQUIRE_FALSE(input.HasNews());
+    REQUIRE_FALSE(input.Take());
+}
+
+//////////////////////////////////////////////////////////////////
+struct LogRecord {
+    std::uint64_t sequence{0};
+    std::uint64_t producer{0};
+};
+
+using LogStream = Stream<LogRecord, 64>;
+using EventStream = Stream<std::uint64_t, 16, StreamMode::Mpmc>;
+
+struct LogProducer {};
+struct LogConsumer {};
+struct EventSourceA {};
+struct EventSourceB {};
+struct EventSinkA {};
+struct EventSinkB {};
+
+PERMISSION_REGISTER_FOR_CREATE(LogProducer, Cache, LogStream, 1);
+PERMISSION_REGISTER_FOR_READ(LogConsumer, Cache, LogStream);
+PERMISSION_REGISTER_FOR_CREATE(EventSourceA, Global, EventStream, 1);
+PERMISSION_REGISTER_FOR_WRITE(EventSourceB, Global, EventStream);
+PERMISSION_REGISTER_FOR_READ(EventSinkA, Global, EventStream);
+PERMISSION_REGISTER_FOR_READ(EventSinkB, Global, EventStream);
+
+SCENARIO("A stream carries items between processors on different threads") {
+    auto& context = DataFramework::Instance().GetContext();
+
+    GIVEN("one producer and one consumer") {
+        LogProducer producer;
+        LogConsumer consumer;
+        LogStream::Producer output = context.Fetch<LogStream>(&producer);
+        LogStream::Consumer input = context.Fetch<LogStream>(&consumer);
+        REQUIRE((output && input));
+
+        // a batch stops at a full stream and an empty one
+        std::vector<LogRecord> records(LogStream::Capacity() + 8);
+        REQUIRE(output.PushBatch(records.begin(), records.end()) == LogStream::Capacity());
+        REQUIRE(input.PopBatch(records.begin(), records.size()) == LogStream::Capacity());
+        LogRecord record;
+        REQUIRE_FALSE(input.Pop(record));
+
+        constexpr std::uint64_t RECORDS = 20000;
+        std::thread producerThread([&output] {
+            LogRecord batch[8];
+            for (std::uint64_t next = 0; next < RECORDS;) {
+                std::size_t count = 0;
+                for (; count < 8 && next + count < RECORDS; count++) {
+                    batch[count].sequence = next + count;
+                }
+                next += output.PushBatch(batch, batch + count);
+            }
+        });
+
+        bool ordered = true;
+        std::uint64_t expected = 0;
+        LogRecord batch[8];
+        while (expected < RECORDS) {
+            std::size_t count = input.PopBatch(batch, 8);
+            for (std::size_t i = 0; i < count; i++) {
+                ordered = ordered && (batch[i].sequence == expected++);
+            }
+        }
+        producerThread.join();
+        REQUIRE(ordered);
+    }
+
+    GIVEN("several producers and consumers") {
+        EventSourceA sourceA;
+        EventSourceB sourceB;
+        EventSinkA sinkA;
+        EventSinkB sinkB;
+
+        constexpr std::uint64_t EVENTS = 5000;
+        auto produce = [](EventStream::Producer output) {
+            for (std::uint64_t event = 1; event <= EVENTS;) {
+                event += output.Push(event) ? 1 : 0;
+            }
+        };
+
+        std::atomic<std::uint64_t> consumed{0};
+        std::atomic<std::uint64_t> sum{0};
+        auto consume = [&consumed, &sum](EventStream::Consumer input) {
+            std::uint64_t event = 0;
+            while (consumed.load() < 2 * EVENTS) {
+                if (input.Pop(event)) {
+                    sum += event;
+                    consumed++;
+                }
+            }
+        };
+
+        std::thread threads[] = {
+            std::thread(produce, context.Fetch<EventStream>(&sourceA)),
+            std::thread(produce, context.Fetch<EventStream>(&sourceB)),
+            std::thread(consume, context.Fetch<EventStream>(&sinkA)),
+            std::thread(consume, context.Fetch<EventStream>(&sinkB)),
+        };
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(consumed.load() == 2 * EVENTS);
+        REQUIRE(sum.load() == EVENTS * (EVENTS + 1));
+    }
+
+    GIVEN("several producers and consumers moving batches") {
+        EventSourceA sourceA;
+        EventSourceB sourceB;
+        EventSinkA sinkA;
+        EventSinkB sinkB;
+
+        // one claim takes a run of slots, a batch pushes what fits of it
+        EventStream::Producer output = context.Fetch<EventStream>(&sourceA);
+        EventStream::Consumer input = context.Fetch<EventStream>(&sinkA);
+        std::vector<std::uint64_t> events(EventStream::Capacity() + 4, 1);
+        REQUIRE(output.PushBatch(events.begin(), events.begin() + 4) == 4);
+        REQUIRE(output.PushBatch(events.begin(), events.end()) == EventStream::Capacity() - 4);
+        REQUIRE(input.PopBatch(events.begin(), 6) == 6);
+        REQUIRE(input.PopBatch(events.begin(), events.size()) == EventStream::Capacity() - 6);
+        REQUIRE(input.PopBatch(events.begin(), events.size()) == 0);
+
+        constexpr std::uint64_t EVENTS = 5000;
+        auto produce = [](EventStream::Producer output) {
+            std::uint64_t batch[4];
+            for (std::uint64_t event = 1; event <= EVENTS;) {
+                std::size_t count = 0;
+                for (; count < 4 && event + count <= EVENTS; count++) {
+                    batch[count] = event + count;
+                }
+                event += output.PushBatch(batch, batch + count);
+            }
+        };
+
+        std::atomic<std::uint64_t> consumed{0};
+        std::atomic<std::uint64_t> sum{0};
+        auto consume = [&consumed, &sum](EventStream::Consumer input) {
+            std::uint64_t batch[4];
+            while (consumed.load() < 2 * EVENTS) {
+                std::size_t count = input.PopBatch(batch, 4);
+                for (std::size_t i = 0; i < count; i++) {
+                    sum += batch[i];
+                }
+                consumed += count;
+            }
+        };
+
+        std::thread threads[] = {
+            std::thread(produce, context.Fetch<EventStream>(&sourceA)),
+            std::thread(produce, context.Fetch<EventStream>(&sourceB)),
+            std::thread(consume, context.Fetch<EventStream>(&sinkA)),
+            std::thread(consume, context.Fetch<EventStream>(&sinkB)),
+        };
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(consumed.load() == 2 * EVENTS);
+        REQUIRE(sum.load() == EVENTS * (EVENTS + 1));
+    }
+}
+
+//////////////////////////////////////////////////////////////////
+struct GuardedCounter {
+    std::mutex mutex;
+    int count{0};
+};
+
+struct CounterOwner {};
+
+PERMISSION_REGISTER_FOR_CREATE(CounterOwner, Frame, GuardedCounter, 1);
+
+SCENARIO("Immovable data keeps its state while the arena grows") {
+    DataManager manager;
+    DataContext context(manager);
+
+    CounterOwner owner;
+    REQUIRE(manager.Apply<ChassisDriver, WheelSpeed, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<CounterOwner, GuardedCounter, LifeSpan::Frame>(AccessMode::Create));
+    auto counter = context.Create<GuardedCounter>(&owner);
+    counter->count = 7;
+
+    auto capacity = manager.GetArena(LifeSpan::Frame).Capacity();
+    REQUIRE(manager.Apply<ChassisDriver, WheelOdometry, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<FrameRecvProcessor, FrameData, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<CalcProcessor, ProcessData, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.GetArena(LifeSpan::Frame).Capacity() > capacity);
+
+    REQUIRE_FALSE(manager.GetArena(LifeSpan::Frame).Contains(counter.Get()));
+    REQUIRE(context.Fetch<GuardedCounter>(&owner).Get() == counter.Get());
+    REQUIRE(context.Fetch<GuardedCounter>(&owner)->count == 7);
+}
+
+SCENARIO("Sealing leaves immovable data and its state in place") {
+    DataManager manager;
+    DataContext context(manager);
+
+    REQUIRE(manager.Apply<ImuFrameRecv, Mailbox<ImuSample>, LifeSpan::Cache>(AccessMode::Create));
+    REQUIRE(manager.Apply<ImuDriver, Mailbox<ImuSample>, LifeSpan::Cache>(AccessMode::Write));
+    REQUIRE(manager.Apply<LogProducer, LogStream, LifeSpan::Cache>(AccessMode::Create));
+    REQUIRE(manager.Apply<LogConsumer, LogStream, LifeSpan::Cache>(AccessMode::Read));
+    REQUIRE(manager.Apply<CalcProcessor, ProcessData, LifeSpan::Cache>(AccessMode::Create));
+    REQUIRE(manager.Apply<ChassisDriver, WheelSpeed, LifeSpan::Frame>(AccessMode::Create));
+    REQUIRE(manager.Apply<CounterOwner, GuardedCounter, LifeSpan::Frame>(AccessMode::Create));
+
+    ImuFrameRecv recv;
+    ImuDriver driver;
+    LogProducer producer;
+    LogConsumer consumer;
+    CounterOwner owner;
+
+    context.Fetch<Mailbox<ImuSample>>(&driver)->Post(ImuSample{5, 5, {1.0f}});
+    LogStream::Producer output = context.Fetch<LogStream>(&producer);
+    for (std::uint64_t sequence = 1; sequence <= 3; sequence++) {
+        REQUIRE(output.Push(LogRecord{sequence, 0}));
+    }
+    auto counter = context.Create<GuardedCounter>(&owner);
+    counter->count = 9;
+
+    manager.Seal();
+
+    auto sample = context.Fetch<Mailbox<ImuSample>>(&recv)->Take();
+    REQUIRE(sample->sequence == 5);
+    REQUIRE(sample->readings.size() == 1);
+
+    LogStream::Consumer input = context.Fetch<LogStream>(&consumer);
+    LogRecord record;
+    for (std::uint64_t sequence = 1; sequence <= 3; sequence++) {
+        REQUIRE(input.Pop(record));
+        REQUIRE(record.sequence == sequence);
+    }
+    REQUIRE_FALSE(input.Pop(record));
+
+    REQUIRE(context.Fetch<GuardedCounter>(&owner).Get() == counter.Get());
+    REQUIRE(context.Fetch<GuardedCounter>(&owner)->count == 9);
+
+    auto& plan = manager.GetMemoryPlan().Of(LifeSpan::Cache);
+    REQUIRE(plan.fixedBytes >= sizeof(Mailbox<ImuSample>) + sizeof(LogStream));
+    REQUIRE(std::count_if(plan.entries.begin(), plan.entries.end(), [](const MemoryPlan::Entry& entry) {
+        return std::string(entry.storage) == "fixed";
+    }) == 2);
+}